@@ -1,5 +1,7 @@
 #include "aizalib.h"
 #include "PolyCore·多项式核心.hpp"
+#include "PolyFFT·FFT多项式.hpp"
+#include "../../数论/FastMod·快速取模.hpp"
 
 /**
  * MTT (任意模数多项式加减乘、求逆、Ln、Exp) - 基于 3模数NTT + CRT
@@ -8,17 +10,21 @@
  * 		求逆、Ln、Exp 包含有理数除法，破坏了整数大小关系，不能直接分三个模数计算再合并，必须在外部写黑盒牛顿迭代。
  * 模板参数: 
  *      依赖全局模数配置：MTT::modP (使用前务必初始化！)
+ *      乘法后端：MTT::backend = MTT::Backend::CRT (默认, 3 次 NTT 卷积 + CRT) / MTT::Backend::FFT (拆系数 FFT, 4 次 FFT)
  * interface: 
  * 		AnyModPoly(vector)
  * 		+ - * / %
  * 		deriv(), integral()
  * 		inverse(n), ln(n), exp(n)
- * 		mul_poly(A, B) -> 调用底层的 3 模数 NTT 乘法
+ * 		mul_poly(A, B) -> 按 MTT::backend 调用 3 模数 NTT 乘法或拆系数 FFT 乘法
  * note:
  * 		1. 时间复杂度: 乘法 O(N log N) / 操作由于不复用点值常数略大
  * 		2. 使用模数: 998244353, 1004535809, 469762049 (原根均为 3)
  * 		3. 初始化方法: `MTT::modP = P;`
  * 		4. 依赖项: PolyCore<MD, G>::mul (仅使用其点值域乘法核心)
+ * 		5. 输入先统一取模到 [0, modP) 再交给后端 (允许负数与未约减的系数)；长度不小于 MTT::par_min 时三个卷积并行 (MTT::threads > 1，需 -pthread)，
+ * 		   Garner 合并在 NTT 模数下用 Montgomery 乘法向量化
+ * 		6. modP 下的取模全部经由 Barrett 约减 (_red())，不做 64 位硬件除法；modP 改变后首次使用时自动重建
  */
 namespace MTT {
 	// 预计算常量
@@ -34,40 +40,83 @@ namespace MTT {
 	// 当前全局模数配置，使用重载运算符前需设定
 	inline int modP = 998244353;
 
+	// modP 的 Barrett 约减器，modP 改变后首次调用时重建
+	inline Barrett32 _bar(998244353);
+	inline const Barrett32& _red() { if (_bar.m != (u32)modP) _bar = Barrett32(modP); return _bar; }
+
 	// 基础整数运算 (依赖全局 modP)
 	inline int add(int a, int b) { return a + b >= modP ? a + b - modP : a + b; }
 	inline int sub(int a, int b) { return a < b ? a - b + modP : a - b; }
-	inline int fpow(int b, int power) {
-		int res = 1;
-		for (; power; power >>= 1, b = 1ll * b * b % modP)
-			if (power & 1) res = 1ll * res * b % modP;
-		return res;
-	}
+	inline int fpow(int b, int power) { return _red().pow(b, power); }
 	inline int inv(int x) { return fpow(x, modP - 2); }
 
+	// 乘法后端，可在运行时切换
+	enum class Backend { CRT, FFT };
+	inline Backend backend = Backend::CRT;
+
+	// 并行配置: 结果长度不小于 par_min 且 threads > 1 时，三个模数的卷积在三个线程上同时进行
+	inline int threads = std::max(1u, std::thread::hardware_concurrency());
+	inline int par_min = 1 << 15;
+
+	// Garner 合并的前两步，均在 NTT 模数下用 Montgomery 乘法完成 (AVX2 下 8 路并行)
+	// 		v2 = (r2 - v1) / m1 mod m2, v3 = (r3 - v1 - v2 m1) / (m1 m2) mod m3，结果写回 r2, r3
+	inline void _garner(const int* r1, int* r2, int* r3, int len) {
+		static const int c2 = P2::_to_mont(inv1_m2), c31 = P3::_to_mont(m1 % m3), c3 = P3::_to_mont(inv12_m3);
+		int i = 0;
+#if defined(__AVX2__)
+		const __m256i M2 = _mm256_set1_epi32(m2), M3 = _mm256_set1_epi32(m3);
+		const __m256i C2 = _mm256_set1_epi32(c2), C31 = _mm256_set1_epi32(c31), C3 = _mm256_set1_epi32(c3);
+		auto red = [](__m256i x, __m256i m) { return _mm256_min_epu32(x, _mm256_sub_epi32(x, m)); };
+		for (; i + 8 <= len; i += 8) {
+			__m256i v1 = _mm256_loadu_si256((const __m256i*)(r1 + i));
+			__m256i x2 = _mm256_loadu_si256((const __m256i*)(r2 + i)), x3 = _mm256_loadu_si256((const __m256i*)(r3 + i));
+			__m256i v2 = P2::_vmmul(red(_mm256_add_epi32(_mm256_sub_epi32(x2, v1), M2), M2), C2);
+			__m256i t = red(_mm256_add_epi32(red(red(v1, M3), M3), P3::_vmmul(v2, C31)), M3);
+			__m256i v3 = P3::_vmmul(red(_mm256_add_epi32(_mm256_sub_epi32(x3, t), M3), M3), C3);
+			_mm256_storeu_si256((__m256i*)(r2 + i), v2);
+			_mm256_storeu_si256((__m256i*)(r3 + i), v3);
+		}
+#endif
+		for (; i < len; ++i) {
+			int v2 = P2::_mmul(P2::sub(r2[i], r1[i]), c2);
+			int t = P3::add(r1[i] % m3, P3::_mmul(v2, c31));
+			r2[i] = v2, r3[i] = P3::_mmul(P3::sub(r3[i], t), c3);
+		}
+	}
+
 	// 任意模数多项式乘法核心 (供合并或多项式乘号调用)
+	// 输入只做一次取模 (两种后端看到的都是 [0, modP) 内的系数)，CRT 后端同时得到三个 NTT 模数下的副本
 	std::vector<int> mul_poly(const std::vector<int>& a, const std::vector<int>& b) {
 		if (a.empty() || b.empty()) return {};
+		// 加上 modP * 2^31 使负数变为非负再约减
+		const Barrett32& br = _red();
+		const i64 off = (i64)modP << 31;
+		if (backend == Backend::FFT) {
+			std::vector<int> na(a.size()), nb(b.size());
+			rep(i, 0, (int)a.size() - 1) na[i] = br.reduce(a[i] + off);
+			rep(i, 0, (int)b.size() - 1) nb[i] = br.reduce(b[i] + off);
+			return poly_fft::mul_mod(na, nb, modP);
+		}
 		int n = a.size(), m = b.size();
 		int len = n + m - 1;
-		
-		std::vector<int> r1(len), r2(len), r3(len);
-		P1::mul(a.data(), n, b.data(), m, r1.data());
-		P2::mul(a.data(), n, b.data(), m, r2.data());
-		P3::mul(a.data(), n, b.data(), m, r3.data());
 
+		std::vector<int> in(3 * (n + m)), r1(len), r2(len), r3(len);
+		int *a1 = in.data(), *a2 = a1 + n, *a3 = a2 + n, *b1 = a3 + n, *b2 = b1 + m, *b3 = b2 + m;
+		rep(i, 0, n - 1) { u32 x = br.reduce(a[i] + off); a1[i] = x % m1, a2[i] = x % m2, a3[i] = x % m3; }
+		rep(i, 0, m - 1) { u32 x = br.reduce(b[i] + off); b1[i] = x % m1, b2[i] = x % m2, b3[i] = x % m3; }
+
+		auto job1 = [&] { P1::mul(a1, n, b1, m, r1.data()); };
+		auto job2 = [&] { P2::mul(a2, n, b2, m, r2.data()); };
+		auto job3 = [&] { P3::mul(a3, n, b3, m, r3.data()); };
+		if (threads > 1 && len >= par_min) {
+			std::thread t2(job2), t3(job3);
+			job1(); t2.join(); t3.join();
+		} else job1(), job2(), job3();
+
+		_garner(r1.data(), r2.data(), r3.data(), len);
 		std::vector<int> ans(len);
-		constexpr i64 m1_mod_m3 = m1 % m3;
-		i64 m1_mod_p = m1 % modP;
-		i64 m1m2_mod_p = 1ll * m1 * m2 % modP;
-
-		rep(i, 0, len - 1) {
-			i64 v1 = r1[i];
-			i64 v2 = (r2[i] - v1 + m2) % m2 * inv1_m2 % m2;
-			i64 v3_sub = (v1 % m3 + (v2 % m3) * m1_mod_m3) % m3;
-			i64 v3 = (r3[i] + m3 - v3_sub) % m3 * inv12_m3 % m3;
-			ans[i] = (v1 + v2 * m1_mod_p + v3 * m1m2_mod_p) % modP;
-		}
+		u64 m1_mod_p = m1 % modP, m1m2_mod_p = 1ull * m1 * m2 % modP;
+		rep(i, 0, len - 1) ans[i] = br.reduce(r1[i] + r2[i] * m1_mod_p + r3[i] * m1m2_mod_p);
 		return ans;
 	}
 
@@ -104,7 +153,8 @@ namespace MTT {
 		AnyModPoly deriv() const {
 			if (empty()) return {};
 			AnyModPoly res(size() - 1);
-			rep(i, 1, (int)size() - 1) res[i - 1] = 1ll * (*this)[i] * i % modP;
+			const Barrett32& br = _red();
+			rep(i, 1, (int)size() - 1) res[i - 1] = br.mul((*this)[i], i);
 			return res;
 		}
 
@@ -112,7 +162,17 @@ namespace MTT {
 			if (empty()) return {};
 			AnyModPoly res(size() + 1);
 			res[0] = 0;
-			rep(i, 0, (int)size() - 1) res[i + 1] = 1ll * (*this)[i] * MTT::inv(i + 1) % modP;
+			// 1..k 的逆元 (k = min(n, modP - 1)): 前缀积求一次逆元再回代；i >= modP 时取 i mod modP 的逆元，整除时为 0
+			const Barrett32& br = _red();
+			int n = size(), k = std::min(n, modP - 1);
+			std::vector<int> pre(k + 1, 1), iv(k + 1);
+			rep(i, 1, k) pre[i] = br.mul(pre[i - 1], i);
+			int t = MTT::inv(pre[k]);
+			per(i, k, 1) iv[i] = br.mul(t, pre[i - 1]), t = br.mul(t, i);
+			rep(i, 1, n) {
+				int r = i < modP ? i : i % modP;
+				res[i] = r ? br.mul((*this)[i - 1], iv[r]) : 0;
+			}
 			return res;
 		}
 
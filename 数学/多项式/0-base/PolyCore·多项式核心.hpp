@@ -1,5 +1,8 @@
 #pragma once
 #include "aizalib.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 /**
  * PolyCore (NTT Based Polynomial Core)
@@ -9,16 +12,33 @@
  *             deriv   integral
  *                 ^   ^
  *                 |  /
- *         sqrt -> inv <- ln <- exp 
- *                         ^     ^
- *                          \   /
- *                           pow
+ *         sqrt -> inv <- div <- ln
+ *                    ^             ^
+ *                    |             |
+ *                   exp <------- pow
  * 
- * * Note: mul, inv, ln, exp, sqrt universally depend on _ntt
+ * * Note: mul, inv, ln, exp, sqrt universally depend on _dif / _dit
+ * 
+ * [ NTT Kernel ]
+ * 		1. 蝶形运算使用 32 位 Montgomery 乘法 (R = 2^32)，旋转因子以 Montgomery 形式存储，
+ * 		   与普通形式的数相乘后直接得到普通形式，数据全程保持在 [0, MD) 内，结果与朴素取模逐位一致
+ * 		2. 编译期按 __AVX512F__ / __AVX2__ 选择 16 路 / 8 路向量蝶形，否则退化为标量实现
+ * 		   (开启方式: -march=native 或 #pragma GCC target("avx2"))
+ * 		3. 旋转因子按层缓存，卷积使用 DIF 正变换 + DIT 逆变换配对，省去位逆序置换；
+ * 		   _dif 的输出为位逆序点值，需要自然序点值时使用 _ntt
+ * 		4. 长度不小于 ntt_block_min (默认 2^22) 的变换走分块的行 / 列两趟实现，并在 ntt_threads 个线程上并行
+ * 		   (两者均可直接修改；多线程编译需 -pthread)
+ * 		5. 要求 MD 为奇素数且 MD < 2^30
+ * 		6. mul 按阈值表 (mul_naive_max / mul_karatsuba_max / mul_trunc_shift) 在朴素、Karatsuba、
+ * 		   截断长度 NTT 与普通 NTT 之间分派；阈值表可由 PolyTune·乘法阈值测定.cpp 在目标机器上生成
+ * 		7. mul_batch 一次接收多组乘法: 小规模的同样走朴素 / Karatsuba，
+ * 		   其余按 NTT 长度分组进行，供乘积树等大量小乘法的场景使用
+ * 		8. inv / ln / exp / sqrt / pow 的输入非零项不超过 sparse_ratio * lg(n) 时改用 O(nk) 的 ODE 递推
  */
 template<int MD, int G>
 struct PolyCore {
 	// Basic Arithmetic
+	static constexpr int mod = MD, g = G;
 	static inline int add(int a, int b) { return a + b >= MD ? a + b - MD : a + b; }
 	static inline int sub(int a, int b) { return a < b ? a - b + MD : a - b; }
 	static inline int mul(int a, int b) { return 1ll * a * b % MD; }
@@ -29,12 +49,71 @@ struct PolyCore {
 	}
 	static inline int inv(int x) { return fp(x, MD - 2); }
 
+	// Montgomery Arithmetic
+	// _mred(x) = x * R^{-1} mod MD，返回值位于 [0, 2MD)，要求 x < MD * 2^32
+	static_assert(MD % 2 == 1 && MD < (1 << 30), "PolyCore requires odd MD < 2^30");
+	static constexpr u32 _NINV = [] { u32 x = MD; rep(i, 1, 5) x *= 2u - MD * x; return -x; }();
+	static constexpr u32 _R2 = (u32)(((u128)1 << 64) % MD);
+	static inline u32 _mred(u64 x) { return (x + (u64)((u32)x * _NINV) * MD) >> 32; }
+	// a 为普通形式, w 为 Montgomery 形式, 返回普通形式的 a * w
+	static inline int _mmul(int a, int w) { u32 r = _mred((u64)a * (u32)w); return r >= (u32)MD ? r - MD : r; }
+	static inline int _to_mont(int x) { return _mmul(x, _R2); }
+
 	// Memory Pool
-	// 静态内存池，避免频繁 new/delete 造成的开销
-	static constexpr int _POOL_SIZE = 4000000; // 4M ints ~ 16MB
-	inline static int _pool[_POOL_SIZE], *_pool_ptr = _pool;
-	static int* _alloc(int n) { return _pool_ptr += n, _pool_ptr - n; }
-	static void _free(int* p) { _pool_ptr = p; }
+	// 线程局部的分块栈式内存池，避免频繁 new/delete 造成的开销
+	// 当前块放不下时切换到下一块 (容量至少翻倍)，已申请的块不归还，供后续复用
+	// 释放必须按申请的逆序进行 (由 Arr 的 RAII 保证)
+	// LOCAL 下为每次申请追加哨兵并记录申请栈，检查越界写入与乱序释放
+	struct _Pool {
+		struct Chunk { std::unique_ptr<int[]> buf; size_t cap = 0, top = 0; };
+		static constexpr size_t _INIT = 1 << 20, _CANARY = 0x5A5A5A5A;
+		std::vector<Chunk> chunks;
+		size_t cur = 0, used = 0, peak = 0;
+#ifdef LOCAL
+		std::vector<std::pair<int*, size_t>> trace;
+#endif
+		// 长度为 0 的申请也占 1 个位置，保证返回的指针落在某个块的 [buf, buf + cap) 内，free 才能定位到它
+		int* alloc(size_t n) {
+			n = std::max<size_t>(n, 1);
+#ifdef LOCAL
+			n += 1;
+#endif
+			if (chunks.empty()) chunks.push_back({std::make_unique<int[]>(std::max(_INIT, n)), std::max(_INIT, n), 0});
+			if (chunks[cur].top + n > chunks[cur].cap) {
+				++cur;
+				if (cur < chunks.size() && chunks[cur].cap < n) chunks.resize(cur);
+				if (cur == chunks.size()) {
+					size_t cap = std::max(chunks.back().cap << 1, n);
+					chunks.push_back({std::make_unique<int[]>(cap), cap, 0});
+				}
+			}
+			int* p = chunks[cur].buf.get() + chunks[cur].top;
+			chunks[cur].top += n, used += n, peak = std::max(peak, used);
+#ifdef LOCAL
+			p[n - 1] = _CANARY, trace.push_back({p, n});
+#endif
+			return p;
+		}
+		void free(int* p) {
+#ifdef LOCAL
+			AST(!trace.empty() && trace.back().first == p && "PolyCore pool: out-of-order free");
+			AST(p[trace.back().second - 1] == (int)_CANARY && "PolyCore pool: buffer overflow");
+			trace.pop_back();
+#endif
+			while (p < chunks[cur].buf.get() || p >= chunks[cur].buf.get() + chunks[cur].cap) {
+				AST(cur > 0 && chunks[cur].top == 0 && "PolyCore pool: pointer not in any chunk");
+				--cur;
+			}
+			used -= chunks[cur].buf.get() + chunks[cur].top - p;
+			chunks[cur].top = p - chunks[cur].buf.get();
+		}
+	};
+	inline static thread_local _Pool _pool;
+	static int* _alloc(int n) { return _pool.alloc(n); }
+	static void _free(int* p) { _pool.free(p); }
+	// 当前线程内存池的历史峰值 / 总容量 (单位: int)
+	static size_t pool_peak() { return _pool.peak; }
+	static size_t pool_capacity() { size_t c = 0; for (auto& ch : _pool.chunks) c += ch.cap; return c; }
 
 	// RAII Wrapper for Memory Pool
 	// 自动管理内存的生命周期
@@ -50,70 +129,452 @@ struct PolyCore {
 	};
 
 	// NTT Helpers
-	// 预处理位逆序置换
-	inline static std::vector<int> _rev;
+	// 预处理位逆序置换，仅供需要自然序点值的 _ntt 使用
+	inline static thread_local std::vector<int> _rev;
 	static void _init_rev(int n) {
 		if ((int)_rev.size() == n) return;
 		_rev.resize(n);
 		rep(i, 0, n - 1) _rev[i] = (_rev[i >> 1] >> 1) | ((i & 1) ? (n >> 1) : 0);
 	}
-
-	// 数论变换 (NTT)
-	// type = 1: DFT, type = -1: IDFT
-	static void _ntt(int* a, int n, int type) {
+	static void _bit_reverse(int* a, int n) {
 		_init_rev(n);
 		rep(i, 0, n - 1) if (i < _rev[i]) std::swap(a[i], a[_rev[i]]);
-		for (int len = 2; len <= n; len <<= 1) {
-			int w_n = fp(G, (MD - 1) / len);
-			if (type == -1) w_n = inv(w_n);
-			for (int i = 0; i < n; i += len) {
-				int w = 1;
-				rep(j, 0, len / 2 - 1) {
-					int u = a[i + j], v = mul(a[i + j + len / 2], w);
-					a[i + j] = add(u, v), a[i + j + len / 2] = sub(u, v);
-					w = mul(w, w_n);
-				}
-			}
+	}
+
+	// 旋转因子表 (Montgomery 形式)，按层缓存: _rt[h + j] = w_{2h}^j, _irt 为其逆 (0 <= j < h)
+	// 只在出现更长的变换时向上扩充，不同长度的变换交替进行时不会重建
+	inline static thread_local std::vector<int> _rt, _irt;
+	static void _prepare_roots(int n) {
+		if ((int)_rt.size() >= n) return;
+		if (_rt.empty()) _rt = _irt = {0, _to_mont(1)};
+		for (int h = _rt.size(); h < n; h <<= 1) {
+			_rt.resize(h << 1), _irt.resize(h << 1);
+			int w = fp(G, (MD - 1) / (h << 1)), w_m = _to_mont(w), iw_m = _to_mont(inv(w));
+			_rt[h] = _irt[h] = _to_mont(1);
+			rep(j, 1, h - 1) _rt[h + j] = _mmul(_rt[h + j - 1], w_m), _irt[h + j] = _mmul(_irt[h + j - 1], iw_m);
+		}
+	}
+
+#if defined(__AVX512F__)
+	// 16 路 Montgomery 乘法，偶数位与奇数位分别用 mul_epu32 计算 64 位乘积后拼回
+	static inline __m512i _vmmul(__m512i a, __m512i w) {
+		const __m512i m = _mm512_set1_epi32(MD), ni = _mm512_set1_epi32(_NINV);
+		__m512i pe = _mm512_mul_epu32(a, w);
+		__m512i po = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(w, 32));
+		pe = _mm512_add_epi64(pe, _mm512_mul_epu32(_mm512_mul_epu32(pe, ni), m));
+		po = _mm512_add_epi64(po, _mm512_mul_epu32(_mm512_mul_epu32(po, ni), m));
+		__m512i r = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(pe, 32), po);
+		return _mm512_min_epu32(r, _mm512_sub_epi32(r, m));
+	}
+#endif
+#if defined(__AVX2__)
+	// 8 路 Montgomery 乘法
+	static inline __m256i _vmmul(__m256i a, __m256i w) {
+		const __m256i m = _mm256_set1_epi32(MD), ni = _mm256_set1_epi32(_NINV);
+		__m256i pe = _mm256_mul_epu32(a, w);
+		__m256i po = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(w, 32));
+		pe = _mm256_add_epi64(pe, _mm256_mul_epu32(_mm256_mul_epu32(pe, ni), m));
+		po = _mm256_add_epi64(po, _mm256_mul_epu32(_mm256_mul_epu32(po, ni), m));
+		__m256i r = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0xAA);
+		return _mm256_min_epu32(r, _mm256_sub_epi32(r, m));
+	}
+#endif
+
+	// 一组长度为 h 的 DIT 蝶形: (x[j], y[j]) <- (x[j] + w[j] y[j], x[j] - w[j] y[j])
+	// 利用 min_epu32 完成条件减法: 若 r < MD，则 r - MD 回绕为大数
+	static void _butterfly(int* x, int* y, const int* w, int h) {
+		int j = 0;
+#if defined(__AVX512F__)
+		const __m512i m16 = _mm512_set1_epi32(MD);
+		for (; j + 16 <= h; j += 16) {
+			__m512i u = _mm512_loadu_si512(x + j);
+			__m512i v = _vmmul(_mm512_loadu_si512(y + j), _mm512_loadu_si512(w + j));
+			__m512i s = _mm512_add_epi32(u, v), d = _mm512_add_epi32(_mm512_sub_epi32(u, v), m16);
+			_mm512_storeu_si512(x + j, _mm512_min_epu32(s, _mm512_sub_epi32(s, m16)));
+			_mm512_storeu_si512(y + j, _mm512_min_epu32(d, _mm512_sub_epi32(d, m16)));
+		}
+#endif
+#if defined(__AVX2__)
+		const __m256i m8 = _mm256_set1_epi32(MD);
+		for (; j + 8 <= h; j += 8) {
+			__m256i u = _mm256_loadu_si256((const __m256i*)(x + j));
+			__m256i v = _vmmul(_mm256_loadu_si256((const __m256i*)(y + j)), _mm256_loadu_si256((const __m256i*)(w + j)));
+			__m256i s = _mm256_add_epi32(u, v), d = _mm256_add_epi32(_mm256_sub_epi32(u, v), m8);
+			_mm256_storeu_si256((__m256i*)(x + j), _mm256_min_epu32(s, _mm256_sub_epi32(s, m8)));
+			_mm256_storeu_si256((__m256i*)(y + j), _mm256_min_epu32(d, _mm256_sub_epi32(d, m8)));
+		}
+#endif
+		for (; j < h; ++j) {
+			int u = x[j], v = _mmul(y[j], w[j]);
+			x[j] = add(u, v), y[j] = sub(u, v);
+		}
+	}
+
+	// 一组长度为 h 的 DIF 蝶形: (x[j], y[j]) <- (x[j] + y[j], (x[j] - y[j]) w[j])
+	static void _butterfly_dif(int* x, int* y, const int* w, int h) {
+		int j = 0;
+#if defined(__AVX512F__)
+		const __m512i m16 = _mm512_set1_epi32(MD);
+		for (; j + 16 <= h; j += 16) {
+			__m512i u = _mm512_loadu_si512(x + j), v = _mm512_loadu_si512(y + j);
+			__m512i s = _mm512_add_epi32(u, v), d = _mm512_add_epi32(_mm512_sub_epi32(u, v), m16);
+			_mm512_storeu_si512(x + j, _mm512_min_epu32(s, _mm512_sub_epi32(s, m16)));
+			_mm512_storeu_si512(y + j, _vmmul(_mm512_min_epu32(d, _mm512_sub_epi32(d, m16)), _mm512_loadu_si512(w + j)));
 		}
-		if (type == -1) {
-			int inv_n = inv(n);
-			rep(i, 0, n - 1) a[i] = mul(a[i], inv_n);
+#endif
+#if defined(__AVX2__)
+		const __m256i m8 = _mm256_set1_epi32(MD);
+		for (; j + 8 <= h; j += 8) {
+			__m256i u = _mm256_loadu_si256((const __m256i*)(x + j)), v = _mm256_loadu_si256((const __m256i*)(y + j));
+			__m256i s = _mm256_add_epi32(u, v), d = _mm256_add_epi32(_mm256_sub_epi32(u, v), m8);
+			_mm256_storeu_si256((__m256i*)(x + j), _mm256_min_epu32(s, _mm256_sub_epi32(s, m8)));
+			_mm256_storeu_si256((__m256i*)(y + j), _vmmul(_mm256_min_epu32(d, _mm256_sub_epi32(d, m8)), _mm256_loadu_si256((const __m256i*)(w + j))));
 		}
+#endif
+		for (; j < h; ++j) {
+			int u = x[j], v = y[j];
+			x[j] = add(u, v), y[j] = _mmul(sub(u, v), w[j]);
+		}
+	}
+
+	// a[i] <- a[i] * c, c 为 Montgomery 形式
+	static void _scale(int* a, int n, int c) {
+		int i = 0;
+#if defined(__AVX512F__)
+		for (__m512i vc = _mm512_set1_epi32(c); i + 16 <= n; i += 16)
+			_mm512_storeu_si512(a + i, _vmmul(_mm512_loadu_si512(a + i), vc));
+#endif
+#if defined(__AVX2__)
+		for (__m256i vc = _mm256_set1_epi32(c); i + 8 <= n; i += 8)
+			_mm256_storeu_si256((__m256i*)(a + i), _vmmul(_mm256_loadu_si256((const __m256i*)(a + i)), vc));
+#endif
+		for (; i < n; ++i) a[i] = _mmul(a[i], c);
+	}
+
+	// 逐点乘法 a[i] <- a[i] * b[i]，两次 Montgomery 乘法 (第二次乘 R^2) 得到普通形式
+	static void _dot(int* a, const int* b, int n) {
+		int i = 0;
+#if defined(__AVX512F__)
+		for (__m512i r2 = _mm512_set1_epi32(_R2); i + 16 <= n; i += 16)
+			_mm512_storeu_si512(a + i, _vmmul(_vmmul(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)), r2));
+#endif
+#if defined(__AVX2__)
+		for (__m256i r2 = _mm256_set1_epi32(_R2); i + 8 <= n; i += 8)
+			_mm256_storeu_si256((__m256i*)(a + i), _vmmul(_vmmul(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))), r2));
+#endif
+		for (; i < n; ++i) a[i] = _mmul(_mmul(a[i], b[i]), _R2);
+	}
+
+	// Cache-blocked / Parallel NTT
+	// n >= ntt_block_min 时把长度 n 看作 R x C 的矩阵 (C = 2^floor(lg n / 2))
+	// 		h >= C 的层只在同一列内配对: 按宽度 _TILE 的列块处理，每块的 R 行常驻缓存 (列变换，含旋转因子)
+	// 		h < C 的层只在同一行内配对: 每行独立完成剩余各层 (行变换)
+	// 两趟分别按列块 / 行切分到 ntt_threads 个线程，运算与逐层实现完全相同，输出顺序不变
+	inline static int ntt_threads = std::max(1u, std::thread::hardware_concurrency());
+	inline static int ntt_block_min = 1 << 22;
+	static constexpr int _TILE = 128;
+
+	// 在 [0, cnt) 上按连续区间切分并行执行 f(i)，主线程负责第一段
+	template<typename F>
+	static void _parallel_for(int cnt, F&& f) {
+		int t = std::max(1, std::min(ntt_threads, cnt));
+		auto run = [&](int k) { for (int i = 1ll * cnt * k / t, e = 1ll * cnt * (k + 1) / t; i < e; ++i) f(i); };
+		std::vector<std::thread> ths;
+		rep(k, 1, t - 1) ths.emplace_back(run, k);
+		run(0);
+		for (auto& th : ths) th.join();
+	}
+
+	static void _dif_blocked(int* a, int n) {
+		int C = 1 << (__builtin_ctz(n) >> 1), R = n / C;
+		const int* rt = _rt.data();
+		_parallel_for(C / _TILE, [&](int b) {
+			for (int h = n >> 1, c = b * _TILE; h >= C; h >>= 1)
+				for (int i = 0; i < n; i += h << 1)
+					for (int r = c; r < h; r += C) _butterfly_dif(a + i + r, a + i + r + h, rt + h + r, _TILE);
+		});
+		_parallel_for(R, [&](int r) {
+			int* row = a + r * C;
+			for (int h = C >> 1; h >= 1; h >>= 1)
+				for (int i = 0; i < C; i += h << 1) _butterfly_dif(row + i, row + i + h, rt + h, h);
+		});
+	}
+	static void _dit_blocked(int* a, int n) {
+		int C = 1 << (__builtin_ctz(n) >> 1), R = n / C, c_inv = _to_mont(inv(n));
+		const int* irt = _irt.data();
+		_parallel_for(R, [&](int r) {
+			int* row = a + r * C;
+			for (int h = 1; h < C; h <<= 1)
+				for (int i = 0; i < C; i += h << 1) _butterfly(row + i, row + i + h, irt + h, h);
+		});
+		_parallel_for(C / _TILE, [&](int b) {
+			for (int h = C, c = b * _TILE; h < n; h <<= 1)
+				for (int i = 0; i < n; i += h << 1)
+					for (int r = c; r < h; r += C) _butterfly(a + i + r, a + i + r + h, irt + h + r, _TILE);
+		});
+		_parallel_for(R, [&](int r) { _scale(a + r * C, C, c_inv); });
+	}
+
+	// DIF 正变换: 自然序输入，位逆序输出
+	// DIT 逆变换: 位逆序输入，自然序输出 (含 1/n)
+	// 二者配对做卷积时点值顺序一致，无需位逆序置换
+	static void _dif(int* a, int n) {
+		_prepare_roots(n);
+		if (n >= std::max(ntt_block_min, _TILE * _TILE)) return _dif_blocked(a, n);
+		for (int h = n >> 1; h >= 1; h >>= 1)
+			for (int i = 0; i < n; i += h << 1) _butterfly_dif(a + i, a + i + h, _rt.data() + h, h);
+	}
+	static void _dit(int* a, int n) {
+		_prepare_roots(n);
+		if (n >= std::max(ntt_block_min, _TILE * _TILE)) return _dit_blocked(a, n);
+		for (int h = 1; h < n; h <<= 1)
+			for (int i = 0; i < n; i += h << 1) _butterfly(a + i, a + i + h, _irt.data() + h, h);
+		_scale(a, n, _to_mont(inv(n)));
+	}
+
+	// 数论变换 (NTT)，输入输出均为自然序
+	// type = 1: DFT, type = -1: IDFT
+	static void _ntt(int* a, int n, int type) {
+		if (type == 1) _dif(a, n), _bit_reverse(a, n);
+		else _bit_reverse(a, n), _dit(a, n);
 	}
 
 	// Public Implementations
 
 	// 多项式乘法
 	// res 数组大小至少为 n + m - 1
+	// 按阈值表分派: 朴素 / Karatsuba / 截断长度 NTT / 普通 NTT
 	static void mul(const int* a, int n, const int* b, int m, int* res) {
+		if (!n || !m) return;
+		if (_use_small(n, m)) return _mul_small(a, n, b, m, res);
+		int len = n + m - 1, limit = 1; while (limit < len) limit <<= 1;
+		int r = len - (limit >> 1);
+		if (limit > 1 && r <= std::min(n, m) && r <= (limit >> 1 >> mul_trunc_shift)) return _mul_trunc(a, n, b, m, res);
+		_mul_ntt(a, n, b, m, res);
+	}
+
+	static void _mul_ntt(const int* a, int n, const int* b, int m, int* res) {
 		int limit = 1; while (limit < n + m - 1) limit <<= 1;
 		Arr ta(limit), tb(limit);
 		ta.copy_from(a, n); ta.fill_zero(n, limit);
 		tb.copy_from(b, m); tb.fill_zero(m, limit);
-		_ntt(ta, limit, 1); _ntt(tb, limit, 1);
-		rep(i, 0, limit - 1) ta[i] = mul(ta[i], tb[i]);
-		_ntt(ta, limit, -1);
+		_dif(ta, limit); _dif(tb, limit);
+		_dot(ta, tb, limit);
+		_dit(ta, limit);
 		ta.copy_to(res, n + m - 1);
 	}
 
-	// 多项式求逆
-	// 要求 a[0] != 0
-	static void inv_impl(const int* a, int n, int* res) {
-		if (n == 1) { res[0] = inv(a[0]); return; }
-		int len = (n + 1) >> 1;
-		inv_impl(a, len, res);
+	// 截断长度 NTT: 结果长度 len 略超过 2 的幂 L 时，只做 L 点循环卷积
+	// 溢出的 r = len - L 项只依赖 a, b 最高的 r 项，单独相乘得到后从循环卷积的前 r 项中减去
+	// 要求 r <= min(n, m)
+	static void _mul_trunc(const int* a, int n, const int* b, int m, int* res) {
+		int len = n + m - 1, L = 1; while (L * 2 < len) L <<= 1;
+		int r = len - L;
+		Arr ta(L), tb(L), hi(2 * r - 1);
+		ta.fill_zero(0, L), tb.fill_zero(0, L);
+		rep(i, 0, n - 1) ta[i & (L - 1)] = add(ta[i & (L - 1)], a[i]);
+		rep(i, 0, m - 1) tb[i & (L - 1)] = add(tb[i & (L - 1)], b[i]);
+		_dif(ta, L); _dif(tb, L);
+		_dot(ta, tb, L);
+		_dit(ta, L);
+		mul(a + n - r, r, b + m - r, r, hi);
+		rep(t, 0, r - 1) res[L + t] = hi[r - 1 + t], res[t] = sub(ta[t], hi[r - 1 + t]);
+		std::copy(ta + r, ta + L, res + r);
+	}
 
-		int limit = 1; while (limit < (n << 1)) limit <<= 1;
-		Arr ta(limit), tb(limit);
+	// Small-size / Batched Multiplication
+	// 阈值表: min(n, m) <= mul_naive_max 用朴素乘法，max(n, m) <= mul_karatsuba_max 用 Karatsuba，
+	// 结果长度超出 2 的幂 L 不多于 L >> mul_trunc_shift 时用截断长度 NTT
+	// 默认值在 AVX2 / AVX-512 下测得，可用 PolyTune·乘法阈值测定.cpp 在目标机器上重新生成
+	inline static int mul_naive_max = 40, mul_karatsuba_max = 56, mul_trunc_shift = 1;
+	static bool _use_small(int n, int m) { return std::min(n, m) <= mul_naive_max || std::max(n, m) <= mul_karatsuba_max; }
 
-		ta.copy_from(a, n); ta.fill_zero(n, limit);
-		tb.copy_from(res, len); tb.fill_zero(len, limit);
+	// 朴素乘法: 输出按 64 项分块，块内 u64 累加 (内层对 a 连续访问，可向量化)
+	// 每累加 16 行取模一次 (MD < 2^30，16 个乘积与余数之和不超过 2^64)
+	static void _mul_naive(const int* a, int n, const int* b, int m, int* res) {
+		u64 acc[64];
+		for (int k0 = 0; k0 < n + m - 1; k0 += 64) {
+			int k1 = std::min(k0 + 64, n + m - 1);
+			std::fill(acc, acc + (k1 - k0), 0);
+			rep(j, 0, m - 1) {
+				u64 bj = (u32)b[j];
+				for (int k = std::max(k0, j), e = std::min(k1, n + j); k < e; ++k) acc[k - k0] += bj * (u32)a[k - j];
+				if ((j & 15) == 15) rep(k, 0, k1 - k0 - 1) acc[k] %= MD;
+			}
+			rep(k, k0, k1 - 1) res[k] = acc[k - k0] % MD;
+		}
+	}
+
+	// Karatsuba: a, b 长度均为 n，res 长度 2n - 1
+	// a = a0 + x^h a1: a0 b0, a1 b1 直接写入 res 的两端，(a0 + a1)(b0 + b1) 减去两者后加到中间
+	static void _karatsuba(const int* a, const int* b, int n, int* res) {
+		if (n <= mul_naive_max) return _mul_naive(a, n, b, n, res);
+		int h = n >> 1, k = n - h;
+		_karatsuba(a, b, h, res);
+		res[2 * h - 1] = 0;
+		_karatsuba(a + h, b + h, k, res + 2 * h);
+		Arr sa(k), sb(k), mid(2 * k - 1);
+		rep(i, 0, k - 1) sa[i] = i < h ? add(a[i], a[h + i]) : a[h + i], sb[i] = i < h ? add(b[i], b[h + i]) : b[h + i];
+		_karatsuba(sa, sb, k, mid);
+		rep(i, 0, 2 * h - 2) mid[i] = sub(mid[i], res[i]);
+		rep(i, 0, 2 * k - 2) mid[i] = sub(mid[i], res[2 * h + i]);
+		rep(i, 0, 2 * k - 2) res[h + i] = add(res[h + i], mid[i]);
+	}
+
+	// 小规模乘法分派: 长的一侧按短的一侧长度分块做 Karatsuba
+	static void _mul_small(const int* a, int n, const int* b, int m, int* res) {
+		if (n < m) std::swap(a, b), std::swap(n, m);
+		if (m <= mul_naive_max) return _mul_naive(a, n, b, m, res);
+		std::fill(res, res + n + m - 1, 0);
+		Arr blk(m), tmp(2 * m - 1);
+		for (int i = 0; i < n; i += m) {
+			int len = std::min(m, n - i);
+			blk.copy_from(a + i, len), blk.fill_zero(len, m);
+			_karatsuba(blk, b, m, tmp);
+			rep(j, 0, len + m - 2) res[i + j] = add(res[i + j], tmp[j]);
+		}
+	}
+
+	// 批量乘法: res_i = a_i * b_i (res_i 大小至少为 n_i + m_i - 1)
+	// 小规模任务走朴素 / Karatsuba；其余按 NTT 长度分组，组内共用一份缓冲区与已预处理的旋转因子
+	// 适合乘积树等一次产生大量小乘法的场景
+	struct MulTask { const int* a; int n; const int* b; int m; int* res; };
+	static void mul_batch(const MulTask* ts, int cnt) {
+		std::vector<std::pair<int, int>> big;
+		rep(i, 0, cnt - 1) {
+			const MulTask& t = ts[i];
+			if (!t.n || !t.m) continue;
+			if (_use_small(t.n, t.m)) _mul_small(t.a, t.n, t.b, t.m, t.res);
+			else {
+				int limit = 1; while (limit < t.n + t.m - 1) limit <<= 1;
+				big.push_back({limit, i});
+			}
+		}
+		if (big.empty()) return;
+		std::sort(big.begin(), big.end());
+		_prepare_roots(big.back().first);
+		for (size_t s = 0, e; s < big.size(); s = e) {
+			int limit = big[s].first;
+			for (e = s; e < big.size() && big[e].first == limit; ++e);
+			Arr ta(limit), tb(limit);
+			for (size_t k = s; k < e; ++k) {
+				const MulTask& t = ts[big[k].second];
+				ta.copy_from(t.a, t.n); ta.fill_zero(t.n, limit);
+				tb.copy_from(t.b, t.m); tb.fill_zero(t.m, limit);
+				_dif(ta, limit); _dif(tb, limit);
+				_dot(ta, tb, limit);
+				_dit(ta, limit);
+				ta.copy_to(t.res, t.n + t.m - 1);
+			}
+		}
+	}
+
+	// 1..n 的逆元表，线性递推，按需扩充
+	inline static thread_local std::vector<int> _ninv{0, 1};
+	static void _prepare_ninv(int n) {
+		for (int i = _ninv.size(); i <= n; ++i) _ninv.push_back(mul(MD - MD / i, _ninv[MD % i]));
+	}
+
+	// 牛顿迭代求逆的一步: 已知 g = a^{-1} mod x^h，就地扩展到 mod x^{2h} (a 只读前 min(2h, n) 项)
+	// 中段积: 长度 2h 的循环卷积中 a g 的回绕只落在 [0, h)，而 [h, 2h) 正是需要的误差项 e
+	// g 的点值在两次乘法中复用，g[h, 2h) = -(g e) mod x^h
+	static void _inv_step(const int* a, int n, int* g, int h) {
+		int m = h << 1, k = std::min(m, n);
+		Arr f(m), t(m);
+		f.copy_from(a, k); f.fill_zero(k, m);
+		t.copy_from(g, h); t.fill_zero(h, m);
+		_dif(f, m); _dif(t, m); _dot(f, t, m); _dit(f, m);
+		f.fill_zero(0, h);
+		_dif(f, m); _dot(f, t, m); _dit(f, m);
+		rep(i, h, m - 1) g[i] = sub(0, f[i]);
+	}
+
+	// Sparse Fast Paths
+	// a 除常数项外只有 k 个非零项时，由 ODE 逐项递推，O(nk):
+	// 		inv: a g = 1					g_j = -(sum a_i g_{j-i}) / a_0
+	// 		ln:  a f' = a' (a_0 = 1)		h_j = j f_j = j a_j - sum a_i h_{j-i}
+	// 		exp: g' = a' g (a_0 = 0)		j g_j = sum i a_i g_{j-i}
+	// 		pow: a g' = k a' g (a_0 = 1)	j g_j = sum ((k+1) i - j) a_i g_{j-i}，sqrt 取 k = 1/2
+	// k 不超过 sparse_ratio * lg(n) 时自动选用 (默认值由实测的交叉点给出)
+	inline static int sparse_ratio = 6;
+	using _Terms = std::vector<std::pair<int, int>>;
+	static bool _sparse(const int* a, int n, _Terms& t) {
+		int lim = sparse_ratio * std::__lg(std::max(n, 2));
+		t.clear();
+		rep(i, 1, n - 1) if (a[i]) {
+			if ((int)t.size() == lim) return false;
+			t.push_back({i, a[i]});
+		}
+		return true;
+	}
+	// sum_{(i, c) in t, i <= j} c * g[j - i]，每 16 项取模一次
+	static int _sparse_dot(const _Terms& t, const int* g, int j) {
+		u64 s = 0;
+		for (int p = 0, e = t.size(); p < e && t[p].first <= j; ) {
+			for (int q = std::min(e, p + 16); p < q && t[p].first <= j; ++p) s += (u64)t[p].second * g[j - t[p].first];
+			s %= MD;
+		}
+		return s;
+	}
+	static void _inv_sparse(const int* a, int n, const _Terms& t, int* res) {
+		int ia = sub(0, inv(a[0]));
+		res[0] = inv(a[0]);
+		rep(j, 1, n - 1) res[j] = mul(_sparse_dot(t, res, j), ia);
+	}
+	static void _ln_sparse(const int* a, int n, const _Terms& t, int* res) {
+		_prepare_ninv(n);
+		Arr h(n);
+		h[0] = res[0] = 0;
+		rep(j, 1, n - 1) {
+			h[j] = sub(mul(j, a[j]), _sparse_dot(t, h, j));
+			res[j] = mul(h[j], _ninv[j]);
+		}
+	}
+	static void _exp_sparse(int n, _Terms t, int* res) {
+		_prepare_ninv(n);
+		for (auto& [i, c] : t) c = mul(c, i);
+		res[0] = 1;
+		rep(j, 1, n - 1) res[j] = mul(_sparse_dot(t, res, j), _ninv[j]);
+	}
+	static void _pow_sparse(int n, int k, const _Terms& t, int* res) {
+		_prepare_ninv(n);
+		_Terms tk = t;
+		for (auto& [i, c] : tk) c = mul(c, mul(k + 1, i));
+		res[0] = 1;
+		rep(j, 1, n - 1) res[j] = mul(sub(_sparse_dot(tk, res, j), mul(j, _sparse_dot(t, res, j))), _ninv[j]);
+	}
 
-		_ntt(ta, limit, 1); _ntt(tb, limit, 1);
-		rep(i, 0, limit - 1) ta[i] = mul(sub(2, mul(ta[i], tb[i])), tb[i]);
-		_ntt(ta, limit, -1);
+	// 多项式求逆
+	// 要求 a[0] != 0
+	// 倍增到不小于 n 的 2 的幂，截断后与逐项递归的结果一致
+	static void inv_impl(const int* a, int n, int* res) {
+		if (_Terms t; _sparse(a, n, t)) return _inv_sparse(a, n, t, res);
+		int N = 1; while (N < n) N <<= 1;
+		Arr g(N);
+		g[0] = inv(a[0]);
+		for (int h = 1; h < n; h <<= 1) _inv_step(a, n, g, h);
+		g.copy_to(res, n);
+	}
 
-		ta.copy_to(res, n);
+	// 幂级数除法 res = b / a mod x^n (b 有 nb 项)
+	// 要求 a[0] != 0
+	// 最后一步牛顿迭代与乘法合并: 只求 a 的半长逆元 g，q0 = b g mod x^h，再用 -(g (a q0 - b)) 修正高半段
+	static void _div_impl(const int* b, int nb, const int* a, int n, int* res) {
+		if (n == 1) { res[0] = nb ? mul(b[0], inv(a[0])) : 0; return; }
+		int h = 1; while ((h << 1) < n) h <<= 1;
+		int m = h << 1, k;
+		Arr tg(m), q(m), t(m), f(m);
+		inv_impl(a, h, tg); tg.fill_zero(h, m); _dif(tg, m);
+		k = std::min(nb, h); q.copy_from(b, k); q.fill_zero(k, m);
+		_dif(q, m); _dot(q, tg, m); _dit(q, m);
+		q.fill_zero(h, m); t.copy_from(q, m);
+		k = std::min(n, m); f.copy_from(a, k); f.fill_zero(k, m);
+		_dif(t, m); _dif(f, m); _dot(f, t, m); _dit(f, m);
+		rep(i, h, m - 1) f[i - h] = sub(f[i], i < nb ? b[i] : 0);
+		f.fill_zero(h, m);
+		_dif(f, m); _dot(f, tg, m); _dit(f, m);
+		rep(i, h, n - 1) q[i] = sub(0, f[i - h]);
+		q.copy_to(res, n);
 	}
 
 	// 多项式求导
@@ -123,76 +584,80 @@ struct PolyCore {
 		
 	// 多项式积分
 	static void integral(const int* a, int n, int* res) {
-		res[0] = 0; rep(i, 0, n - 1) res[i + 1] = mul(a[i], inv(i + 1));
+		_prepare_ninv(n);
+		res[0] = 0; rep(i, 0, n - 1) res[i + 1] = mul(a[i], _ninv[i + 1]);
 	}
 
 	// 多项式对数函数 ln(A)
 	// 要求 a[0] = 1
 	static void ln(const int* a, int n, int* res) {
-		Arr da(n - 1), ia(n);
-		deriv(a, n, da); inv_impl(a, n, ia);
-
-		int limit = 1; while (limit < (n + n - 2)) limit <<= 1;
-		Arr ta(limit), tb(limit);
-
-		ta.copy_from(da, n - 1); ta.fill_zero(n - 1, limit);
-		tb.copy_from(ia, n); tb.fill_zero(n, limit);
-
-		_ntt(ta, limit, 1); _ntt(tb, limit, 1);
-		rep(i, 0, limit - 1) ta[i] = mul(ta[i], tb[i]);
-		_ntt(ta, limit, -1);
-
-		integral(ta, n - 1, res);
+		if (n == 1) { res[0] = 0; return; }
+		if (_Terms t; _sparse(a, n, t)) return _ln_sparse(a, n, t, res);
+		Arr da(n - 1), q(n - 1);
+		deriv(a, n, da); _div_impl(da, n - 1, a, n - 1, q);
+		integral(q, n - 1, res);
 	}
 
 	// 多项式指数函数 exp(A)
 	// 要求 a[0] = 0
+	// 同时倍增 f = exp(A) 与 g = f^{-1}，不再每步调用 ln:
+	// 		q = a' mod x^{m-1}, w = q + g (f' - f q) = f'/f mod x^{2m-1}, f <- f + f (a - ∫w) mod x^{2m}
+	// 		f' - f q 在 x^{m-1} 以下为 0，f 的点值在两次乘法中复用
 	static void exp(const int* a, int n, int* res) {
-		if (n == 1) { res[0] = 1; return; }
-		int len = (n + 1) >> 1; exp(a, len, res);
-		Arr ln_b(n); ln(res, n, ln_b);
-
-		int limit = 1; while (limit < (n << 1)) limit <<= 1;
-		Arr ta(limit), tb(limit);
-
-		rep(i, 0, n - 1) {
-			int val = sub(a[i], ln_b[i]);
-			if (i == 0) val = add(val, 1);
-			ta[i] = val;
-		}
-		ta.fill_zero(n, limit);
-		tb.copy_from(res, len); tb.fill_zero(len, limit);
-
-		_ntt(ta, limit, 1); _ntt(tb, limit, 1);
-		rep(i, 0, limit - 1) ta[i] = mul(ta[i], tb[i]);
-		_ntt(ta, limit, -1);
-
-		ta.copy_to(res, n);
+		if (_Terms t; _sparse(a, n, t)) return _exp_sparse(n, std::move(t), res);
+		int N = 1; while (N < n) N <<= 1;
+		Arr f(N), g(N);
+		f[0] = g[0] = 1;
+		for (int m = 1; m < n; m <<= 1) _exp_step(a, n, f, g, m);
+		f.copy_to(res, n);
+	}
+	// exp 倍增的一步: 已知 f = exp(A) mod x^m，g = f^{-1} mod x^{max(1, m/2)}，
+	// 就地扩展为 f mod x^{2m}，g mod x^m (a 只读前 min(2m, n) 项)
+	static void _exp_step(const int* a, int n, int* f, int* g, int m) {
+		if (m > 1) _inv_step(f, m, g, m >> 1);
+		int l = m << 1;
+		_prepare_ninv(l);
+		Arr tf(l), tg(l), t(l);
+		tf.copy_from(f, m); tf.fill_zero(m, l); _dif(tf, l);
+		tg.copy_from(g, m); tg.fill_zero(m, l); _dif(tg, l);
+		deriv(a, std::min(m, n), t); t.fill_zero(std::min(m, n) - 1, l);
+		_dif(t, l); _dot(t, tf, l); _dit(t, l);
+		rep(i, 0, m - 1) t[i] = sub(0, t[m - 1 + i]);
+		t.fill_zero(m, l);
+		_dif(t, l); _dot(t, tg, l); _dit(t, l);
+		rep(i, 0, m - 1) t[i] = sub(m + i < n ? a[m + i] : 0, mul(t[i], _ninv[m + i]));
+		t.fill_zero(m, l);
+		_dif(t, l); _dot(t, tf, l); _dit(t, l);
+		rep(i, 0, m - 1) f[m + i] = t[i];
 	}
 
 	// 多项式开方 sqrt(A)
 	// 要求 a[0] = 1
+	// 同时倍增 s = sqrt(A) 与 g = s^{-1}: s <- s + (a - s^2) g / 2
+	// s^2 的高半段由长度 m 的循环卷积得到: c[i] = s^2[i] + s^2[i + m]，而 s^2[i] = a[i] (i < m)
 	static void sqrt(const int* a, int n, int* res) {
-		if (n == 1) { res[0] = 1; return; }
-		int len = (n + 1) >> 1; sqrt(a, len, res);
-		Arr inv_res(n); inv_impl(res, n, inv_res);
-
-		int limit = 1; while (limit < (n << 1)) limit <<= 1;
-		Arr ta(limit), tb(limit);
-
-		ta.copy_from(a, n); ta.fill_zero(n, limit);
-		tb.copy_from(inv_res, n); tb.fill_zero(n, limit);
-
-		_ntt(ta, limit, 1); _ntt(tb, limit, 1);
-		rep(i, 0, limit - 1) ta[i] = mul(ta[i], tb[i]);
-		_ntt(ta, limit, -1);
-
+		if (_Terms t; _sparse(a, n, t)) return _pow_sparse(n, inv(2), t, res);
+		int N = 1; while (N < n) N <<= 1;
+		Arr s(N), g(N);
+		s[0] = g[0] = 1;
 		int inv2 = inv(2);
-		rep(i, 0, n - 1) res[i] = mul(add(res[i], ta[i]), inv2);
+		for (int m = 1; m < n; m <<= 1) {
+			if (m > 1) _inv_step(s, m, g, m >> 1);
+			int l = m << 1;
+			Arr c(m), t(l), tg(l);
+			c.copy_from(s, m); _dif(c, m); _dot(c, c, m); _dit(c, m);
+			rep(i, 0, m - 1) t[i] = sub(m + i < n ? a[m + i] : 0, sub(c[i], a[i]));
+			t.fill_zero(m, l);
+			tg.copy_from(g, m); tg.fill_zero(m, l);
+			_dif(t, l); _dif(tg, l); _dot(t, tg, l); _dit(t, l);
+			rep(i, 0, m - 1) s[m + i] = mul(t[i], inv2);
+		}
+		s.copy_to(res, n);
 	}
 
 	// 多项式幂函数 A^k
 	static void pow(const int* a, int n, int k, int* res) {
+		if (_Terms t; _sparse(a, n, t)) return _pow_sparse(n, (k % MD + MD) % MD, t, res);
 		Arr ln_a(n); ln(a, n, ln_a);
 		rep(i, 0, n - 1) ln_a[i] = mul(ln_a[i], k);
 		exp(ln_a, n, res);
@@ -1,60 +1,161 @@
+#pragma once
 #include "aizalib.h"
+#include "../../数论/FastMod·快速取模.hpp"
+
+/**
+ * FFT 多项式乘法 / 拆系数 FFT 任意模数乘法
+ * Interface:
+ * 		FFTEngine<T>::fft(a, n, inverse)				// 原位复数 FFT，T 为浮点类型 (double / long double)
+ * 		FFTEngine<T>::rfft(x, nx, n, X) / irfft(X, n, x, nx)	// 实序列 FFT，n 点实序列只做 n / 2 点复数 FFT
+ * 		FFTEngine<T>::convolve(a, na, b, nb, res, buf)	// 实数卷积，buf 由调用方提供 (buffer_size(len) 个复数)
+ * 		poly_fft::FFT(a, n, type)						// 原位 FFT，type = 1 正变换，-1 逆变换 (含 1/n)
+ * 		poly_fft::multiply_fft(a, b, deg_a, deg_b, res)	// 整数多项式乘法，结果四舍五入
+ * 		poly_fft::mul_mod(a, b, p)						// 任意模数乘法 (4 次 FFT)，系数需在 [0, p)
+ * Note:
+ * 		1. 单位根表按层缓存，每一项直接由 long double 的 cos / sin 计算，不做累乘，误差不随长度累积
+ * 		2. 实数卷积用 rfft 打包，3 次 n / 2 点 FFT，约为复数 FFT 卷积的一半开销
+ * 		3. mul_mod 将系数按 2^15 拆成高低两半，要求 p < 2^30；
+ * 		   p ~ 1e9 时结果长度不超过 2^21 可保证精度 (实测 2^22 开始出错)
+ */
 
 const double pi = acos(-1.0);
 
-struct comp {
-	double re, im;
-	comp(double a = 0, double b = 0) : re(a), im(b) {}
-	comp operator + (const comp& t) const { return {re + t.re, im + t.im}; }
-	comp operator - (const comp& t) const { return {re - t.re, im - t.im}; }
-	comp operator * (const comp& t) const { return {re * t.re - im * t.im, re * t.im + im * t.re}; }
+template<typename T>
+struct Complex {
+	T re, im;
+	Complex(T a = 0, T b = 0) : re(a), im(b) {}
+	Complex operator + (const Complex& t) const { return {re + t.re, im + t.im}; }
+	Complex operator - (const Complex& t) const { return {re - t.re, im - t.im}; }
+	Complex operator * (const Complex& t) const { return {re * t.re - im * t.im, re * t.im + im * t.re}; }
+	Complex operator * (T k) const { return {re * k, im * k}; }
+	Complex conj() const { return {re, -im}; }
 };
+using comp = Complex<double>;
 
-namespace Poly {
-	void FFT(comp tmp[], int n, int type) {
-		static int rev[N];
-		int lg = __builtin_ctz(n);
-		
-		rep(i, 1, n - 1) {
-			rev[i] = (rev[i >> 1] >> 1) | ((i & 1) << (lg - 1));
-		}
-		
-		rep(i, 0, n - 1) 
-			if (i < rev[i]) std::swap(tmp[i], tmp[rev[i]]);
-		
-		for (int len = 2; len <= n; len <<= 1) {
-			comp w1(cos(2 * pi / len), type * sin(2 * pi / len));
-			for (int i = 0; i < n; i += len) {
-				comp w(1, 0);
-				int mid = len >> 1;
-				for (int p = i; p < i + mid; ++p, w = w * w1) {
-					comp x = tmp[p], y = w * tmp[p + mid];
-					tmp[p] = x + y;
-					tmp[p + mid] = x - y;
+namespace poly_fft {
+	template<typename T = double>
+	struct FFTEngine {
+		using C = Complex<T>;
+
+		// 单位根表: _rt[h + j] = e^{i pi j / h} (0 <= j < h)
+		inline static std::vector<C> _rt{C(0, 0), C(1, 0)};
+		static void prepare(int n) {
+			for (int h = _rt.size(); h < n; h <<= 1) {
+				_rt.resize(h << 1);
+				rep(j, 0, h - 1) {
+					long double t = acosl(-1.0L) * j / h;
+					_rt[h + j] = C(cosl(t), sinl(t));
 				}
 			}
 		}
-		
-		if (type == -1) 
-			rep(i, 0, n - 1) tmp[i].re /= n;
-	}
+
+		// 原位 FFT，自然序输入输出
+		// 逆变换利用 IDFT(a) = DFT(a[0], a[n-1], ..., a[1]) / n
+		static void fft(C* a, int n, bool inverse = false) {
+			if (inverse) std::reverse(a + 1, a + n);
+			for (int i = 1, j = 0; i < n; ++i) {
+				for (int k = n >> 1; (j ^= k) < k; k >>= 1);
+				if (i < j) std::swap(a[i], a[j]);
+			}
+			prepare(n);
+			for (int h = 1; h < n; h <<= 1)
+				for (int i = 0; i < n; i += h << 1)
+					rep(j, 0, h - 1) {
+						C x = a[i + j], y = _rt[h + j] * a[i + j + h];
+						a[i + j] = x + y, a[i + j + h] = x - y;
+					}
+			if (inverse) rep(i, 0, n - 1) a[i] = a[i] * (T(1) / n);
+		}
+
+		// e^{2 pi i k / n}, 0 <= k <= n / 2
+		static C _w(int k, int m) { return k == m ? C(-1, 0) : _rt[m + k]; }
+
+		// 实序列 FFT (two for one): 长度 n 的实序列 x (只读前 nx 项，其余视为 0)
+		// 打包为 m = n / 2 个复数 z[k] = x[2k] + i x[2k+1] 做一次 m 点 FFT，再拆出偶 / 奇下标的频谱:
+		// 		E[k] = (Z[k] + conj Z[m-k]) / 2, O[k] = (Z[k] - conj Z[m-k]) / 2i, X[k] = E[k] + w^k O[k]
+		// 输出 X[0..m] 共 m + 1 项，其余由共轭对称 X[n-k] = conj X[k] 得到
+		static void rfft(const T* x, int nx, int n, C* X) {
+			int m = n >> 1;
+			rep(k, 0, m - 1) X[k] = C(2 * k < nx ? x[2 * k] : 0, 2 * k + 1 < nx ? x[2 * k + 1] : 0);
+			fft(X, m), prepare(n);
+			X[m] = X[0];
+			for (int k = 0, j = m; k <= j; ++k, --j) {
+				C zk = X[k], zj = X[j];
+				C e = (zk + zj.conj()) * T(0.5), o = (zk - zj.conj()) * T(0.5);
+				C e2 = (zj + zk.conj()) * T(0.5), o2 = (zj - zk.conj()) * T(0.5);
+				X[k] = e + _w(k, m) * C(o.im, -o.re);
+				X[j] = e2 + _w(j, m) * C(o2.im, -o2.re);
+			}
+		}
+
+		// rfft 的逆: 由 X[0..m] 还原实序列的前 nx 项，X 会被改写
+		static void irfft(C* X, int n, T* x, int nx) {
+			int m = n >> 1;
+			prepare(n);
+			for (int k = 0, j = m; k <= j; ++k, --j) {
+				C xk = X[k], xj = X[j];
+				C e = (xk + xj.conj()) * T(0.5), o = (xk - xj.conj()) * _w(k, m).conj() * T(0.5);
+				C e2 = (xj + xk.conj()) * T(0.5), o2 = (xj - xk.conj()) * _w(j, m).conj() * T(0.5);
+				X[k] = C(e.re - o.im, e.im + o.re);
+				X[j] = C(e2.re - o2.im, e2.im + o2.re);
+			}
+			fft(X, m, true);
+			rep(i, 0, nx - 1) x[i] = (i & 1) ? X[i >> 1].im : X[i >> 1].re;
+		}
+
+		// 实数卷积 res[0, na + nb - 1) = a * b，共 3 次 n / 2 点 FFT
+		// buf 由调用方提供，至少 buffer_size(na + nb - 1) 个复数，内部不分配内存
+		static int buffer_size(int len) { int n = 2; while (n < len) n <<= 1; return n + 2; }
+		static void convolve(const T* a, int na, const T* b, int nb, T* res, C* buf) {
+			int len = na + nb - 1, n = 2;
+			while (n < len) n <<= 1;
+			int m = n >> 1;
+			C *A = buf, *B = buf + m + 1;
+			rfft(a, na, n, A), rfft(b, nb, n, B);
+			rep(k, 0, m) A[k] = A[k] * B[k];
+			irfft(A, n, res, len);
+		}
+	};
+	using FFTd = FFTEngine<double>;
+
+	void FFT(comp tmp[], int n, int type) { FFTd::fft(tmp, n, type == -1); }
 
 	void multiply_fft(int a[], int b[], int deg_a, int deg_b, int res[]) {
-		int n = 1;
-		while (n <= deg_a + deg_b) n <<= 1;
-		
-		static comp ta[N], tb[N];
-		rep(i, 0, deg_a) ta[i] = comp(a[i], 0);
-		rep(i, deg_a + 1, n - 1) ta[i] = comp(0, 0);
-		rep(i, 0, deg_b) tb[i] = comp(b[i], 0);
-		rep(i, deg_b + 1, n - 1) tb[i] = comp(0, 0);
-		
-		FFT(ta, n, 1);
-		FFT(tb, n, 1);
-		rep(i, 0, n - 1) ta[i] = ta[i] * tb[i];
-		FFT(ta, n, -1);
-		
-		rep(i, 0, deg_a + deg_b) 
-			res[i] = (int)(ta[i].re + 0.5);
+		int len = deg_a + deg_b + 1;
+		std::vector<double> ta(a, a + deg_a + 1), tb(b, b + deg_b + 1), tr(len);
+		std::vector<comp> buf(FFTd::buffer_size(len));
+		FFTd::convolve(ta.data(), deg_a + 1, tb.data(), deg_b + 1, tr.data(), buf.data());
+		rep(i, 0, len - 1) res[i] = (int)std::llround(tr[i]);
+	}
+
+	/**
+	 * 拆系数 FFT (4 次 FFT)
+	 * 		x = x_hi * 2^15 + x_lo，打包 L = A_hi + i A_lo, R = B_hi + i B_lo 各做一次正变换
+	 * 		由共轭对称拆出 FFT(A_hi) = (L[k] + conj(L[-k])) / 2, FFT(A_lo) = (L[k] - conj(L[-k])) / 2i
+	 * 		再打包 A_hi R 与 A_lo R 各做一次变换 (下标取反后的正变换即逆变换) 得到四个乘积
+	 */
+	inline std::vector<int> mul_mod(const std::vector<int>& a, const std::vector<int>& b, int p) {
+		if (a.empty() || b.empty()) return {};
+		int len = a.size() + b.size() - 1, n = 1;
+		while (n < len) n <<= 1;
+		std::vector<comp> L(n), R(n), outl(n), outs(n);
+		rep(i, 0, (int)a.size() - 1) L[i] = comp(a[i] >> 15, a[i] & 32767);
+		rep(i, 0, (int)b.size() - 1) R[i] = comp(b[i] >> 15, b[i] & 32767);
+		FFTd::fft(L.data(), n), FFTd::fft(R.data(), n);
+		rep(i, 0, n - 1) {
+			int j = -i & (n - 1);
+			comp hi = (L[i] + L[j].conj()) * (0.5 / n), lo = (L[i] - L[j].conj()) * (0.5 / n);
+			outl[j] = hi * R[i];
+			outs[j] = comp(lo.im, -lo.re) * R[i];
+		}
+		FFTd::fft(outl.data(), n), FFTd::fft(outs.data(), n);
+		std::vector<int> res(len);
+		Barrett32 br(p);
+		rep(i, 0, len - 1) {
+			u64 av = br.reduce(std::llround(outl[i].re)), cv = br.reduce(std::llround(outs[i].im));
+			u64 bv = br.reduce(std::llround(outl[i].im) + std::llround(outs[i].re));
+			res[i] = br.reduce((u64)br.reduce((av << 15) + bv) * 32768 + cv);
+		}
+		return res;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include "aizalib.h"
+#include "Poly·多项式全家桶.hpp"
+
+/**
+ * [多项式惰性表达式]
+ * 算法介绍:
+ * 		lazy(A) 把多项式包装为表达式叶子，之后的 + - * 与数乘只在编译期拼出表达式类型，不做运算
+ * 		求值时整棵树在同一个 NTT 长度的点值上一次算完:
+ * 			叶子各做一次正变换 (同一多项式在表达式中多次出现只变换一次)，
+ * 			内部结点逐点加 / 减 / 乘，最后只做一次逆变换
+ *
+ * Interface:
+ * 		auto e = lazy(A) * B + lazy(C) * D - 3 * lazy(E);
+ * 		Poly r = e;				// 等价于 e.eval()
+ * 		e.eval(n)				// 只求 mod x^n，叶子先截断到 n 项，变换长度随之缩短
+ * 		e % M					// 取模
+ * 		PolyModulus<Poly> pm(M); e % pm	// 同一模数反复使用: 缓存 rev(M) 的逆元与 M 的点值
+ *
+ * Note:
+ * 		1. 表达式只保存叶子的引用，叶子需在求值前保持存活；lazy(临时对象) 与表达式和临时多项式的混合运算均已删除，
+ * 		   如 `e + (B * C)` 需先把 B * C 存入具名变量
+ * 		2. 变换长度由整棵树结果的项数决定，乘法链越长变换越长；只需要低次项时用 eval(n)
+ * 		3. 取模: 先一次变换算出被除式 E，商 Q 由 rev(E) 与 rev(M) 的逆元求出，
+ * 		   余数只需低 deg M 项，在长度 L >= deg M 的循环卷积上算 E - MQ (mod x^L - 1)
+ */
+namespace poly_lazy {
+	// 一次求值的上下文: 变换长度、截断长度与叶子点值缓存
+	template<typename P>
+	struct _Ctx {
+		using Core = typename P::Core;
+		int L, cap;
+		std::vector<std::pair<const P*, std::vector<int>>> cache;
+		const int* leaf(const P& a) {
+			for (auto& [p, v] : cache) if (p == &a) return v.data();
+			std::vector<int> v(L, 0);
+			std::copy(a.begin(), a.begin() + std::min((int)a.size(), cap), v.begin());
+			Core::_dif(v.data(), L);
+			cache.push_back({&a, std::move(v)});
+			return cache.back().second.data();
+		}
+	};
+
+	template<typename P, typename Derived>
+	struct _Expr {
+		using poly_type = P;
+		using Core = typename P::Core;
+		const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+		// 求值，结果只保留 mod x^cap 的部分
+		P eval(int cap = INT_MAX) const {
+			int s = self().size(cap);
+			if (s <= 0) return {};
+			_Ctx<P> ctx{1, cap, {}};
+			while (ctx.L < s) ctx.L <<= 1;
+			typename Core::Arr out(ctx.L);
+			self().freq(out, ctx);
+			Core::_dit(out, ctx.L);
+			return P(out.ptr, out.ptr + std::min(s, cap));
+		}
+		operator P() const { return eval(); }
+	};
+
+	template<typename E>
+	concept PolyExpr = requires { typename E::poly_type; } && std::is_base_of_v<_Expr<typename E::poly_type, E>, E>;
+
+	// 叶子
+	template<typename P>
+	struct Leaf : _Expr<P, Leaf<P>> {
+		const P* a;
+		Leaf(const P& a) : a(&a) {}
+		int size(int cap) const { return std::min((int)a->size(), cap); }
+		void freq(int* out, _Ctx<P>& c) const { const int* v = c.leaf(*a); std::copy(v, v + c.L, out); }
+	};
+
+	// 加减: sign = 1 为加，-1 为减
+	template<typename A, typename B, int sign>
+	struct Sum : _Expr<typename A::poly_type, Sum<A, B, sign>> {
+		using P = typename A::poly_type;
+		A a; B b;
+		Sum(const A& a, const B& b) : a(a), b(b) {}
+		int size(int cap) const { return std::max(a.size(cap), b.size(cap)); }
+		void freq(int* out, _Ctx<P>& c) const {
+			a.freq(out, c);
+			typename P::Core::Arr t(c.L);
+			b.freq(t, c);
+			if (sign == 1) rep(i, 0, c.L - 1) out[i] = P::Core::add(out[i], t[i]);
+			else rep(i, 0, c.L - 1) out[i] = P::Core::sub(out[i], t[i]);
+		}
+	};
+
+	// 乘法
+	template<typename A, typename B>
+	struct Prod : _Expr<typename A::poly_type, Prod<A, B>> {
+		using P = typename A::poly_type;
+		A a; B b;
+		Prod(const A& a, const B& b) : a(a), b(b) {}
+		int size(int cap) const { int sa = a.size(cap), sb = b.size(cap); return sa && sb ? sa + sb - 1 : 0; }
+		void freq(int* out, _Ctx<P>& c) const {
+			a.freq(out, c);
+			typename P::Core::Arr t(c.L);
+			b.freq(t, c);
+			P::Core::_dot(out, t, c.L);
+		}
+	};
+
+	// 数乘
+	template<typename A>
+	struct Scale : _Expr<typename A::poly_type, Scale<A>> {
+		using P = typename A::poly_type;
+		A a; int k;
+		Scale(const A& a, int k) : a(a), k((k % P::Core::mod + P::Core::mod) % P::Core::mod) {}
+		int size(int cap) const { return a.size(cap); }
+		void freq(int* out, _Ctx<P>& c) const { a.freq(out, c); P::Core::_scale(out, c.L, P::Core::_to_mont(k)); }
+	};
+
+	template<int MD, int G, int I>
+	Leaf<Polynomial<MD, G, I>> lazy(const Polynomial<MD, G, I>& a) { return Leaf<Polynomial<MD, G, I>>(a); }
+	template<int MD, int G, int I>
+	void lazy(const Polynomial<MD, G, I>&&) = delete;
+
+	template<PolyExpr A, PolyExpr B> Sum<A, B, 1> operator+(const A& a, const B& b) { return {a, b}; }
+	template<PolyExpr A, PolyExpr B> Sum<A, B, -1> operator-(const A& a, const B& b) { return {a, b}; }
+	template<PolyExpr A, PolyExpr B> Prod<A, B> operator*(const A& a, const B& b) { return {a, b}; }
+	template<PolyExpr A> auto operator+(const A& a, const typename A::poly_type& b) { return a + lazy(b); }
+	template<PolyExpr A> auto operator-(const A& a, const typename A::poly_type& b) { return a - lazy(b); }
+	template<PolyExpr A> auto operator*(const A& a, const typename A::poly_type& b) { return a * lazy(b); }
+	template<PolyExpr B> auto operator+(const typename B::poly_type& a, const B& b) { return lazy(a) + b; }
+	template<PolyExpr B> auto operator-(const typename B::poly_type& a, const B& b) { return lazy(a) - b; }
+	template<PolyExpr B> auto operator*(const typename B::poly_type& a, const B& b) { return lazy(a) * b; }
+	template<PolyExpr A> void operator+(const A&, typename A::poly_type&&) = delete;
+	template<PolyExpr A> void operator-(const A&, typename A::poly_type&&) = delete;
+	template<PolyExpr A> void operator*(const A&, typename A::poly_type&&) = delete;
+	template<PolyExpr B> void operator+(typename B::poly_type&&, const B&) = delete;
+	template<PolyExpr B> void operator-(typename B::poly_type&&, const B&) = delete;
+	template<PolyExpr B> void operator*(typename B::poly_type&&, const B&) = delete;
+	template<PolyExpr A> Scale<A> operator*(const A& a, int k) { return {a, k}; }
+	template<PolyExpr A> Scale<A> operator*(int k, const A& a) { return {a, k}; }
+
+	// 模数 M (最高次项系数不为 0)，缓存 rev(M) 的逆元与各长度下 M mod (x^L - 1) 的点值
+	template<typename P>
+	struct PolyModulus {
+		using Core = typename P::Core;
+		P M, irev;
+		std::vector<std::pair<int, std::vector<int>>> mf;
+		PolyModulus(const P& M) : M(M) {}
+
+		const int* _mfreq(int L) {
+			for (auto& [l, v] : mf) if (l == L) return v.data();
+			std::vector<int> v(L, 0);
+			rep(i, 0, (int)M.size() - 1) v[i & (L - 1)] = Core::add(v[i & (L - 1)], M[i]);
+			Core::_dif(v.data(), L);
+			mf.push_back({L, std::move(v)});
+			return mf.back().second.data();
+		}
+
+		// e 的余数 (e 为系数形式)
+		P reduce(const P& e) {
+			int m = M.size(), s = e.size();
+			if (s < m) return e;
+			int k = s - m + 1;
+			if ((int)irev.size() < k) {
+				P R(M.rbegin(), M.rend());
+				R.resize(k);
+				irev = R.inverse(k);
+			}
+			// Q = rev(rev(e) * rev(M)^{-1} mod x^k)
+			P re(e.rbegin(), e.rbegin() + k), iv(irev.begin(), irev.begin() + k);
+			P Q = re * iv;
+			Q.resize(k);
+			std::reverse(Q.begin(), Q.end());
+			if (m == 1) return {};
+			// R = e - M Q (mod x^L - 1)，L >= m - 1
+			int L = 1; while (L < m - 1) L <<= 1;
+			typename Core::Arr tq(L), te(L);
+			tq.fill_zero(0, L), te.fill_zero(0, L);
+			rep(i, 0, k - 1) tq[i & (L - 1)] = Core::add(tq[i & (L - 1)], Q[i]);
+			rep(i, 0, s - 1) te[i & (L - 1)] = Core::add(te[i & (L - 1)], e[i]);
+			Core::_dif(tq, L);
+			Core::_dot(tq, _mfreq(L), L);
+			Core::_dit(tq, L);
+			P res(m - 1);
+			rep(i, 0, m - 2) res[i] = Core::sub(te[i], tq[i]);
+			return res;
+		}
+	};
+
+	template<PolyExpr E> typename E::poly_type operator%(const E& e, PolyModulus<typename E::poly_type>& pm) { return pm.reduce(e.eval()); }
+	template<PolyExpr E> typename E::poly_type operator%(const E& e, const typename E::poly_type& M) {
+		PolyModulus<typename E::poly_type> pm(M);
+		return pm.reduce(e.eval());
+	}
+} // namespace poly_lazy
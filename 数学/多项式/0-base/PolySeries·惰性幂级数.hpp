@@ -0,0 +1,164 @@
+#pragma once
+#include "aizalib.h"
+#include "Poly·多项式全家桶.hpp"
+
+/**
+ * [惰性幂级数]
+ * 算法介绍:
+ * 		Series 表示一个按需计算的无穷幂级数，已算出的前缀缓存在结点中
+ * 		取第 i 项时若精度不够，把精度倍增到不小于 i + 1 的 2 的幂，只补算新增的部分
+ * 		级数之间可以任意组合 (+ - * 数乘 inverse ln exp pow)，组合结果同样是惰性的，
+ * 		子级数被多个结点共用时只计算一次
+ *
+ * Interface:
+ * 		Series<Poly> A(poly);				// 多项式 (之后的项为 0)
+ * 		auto B = Series<Poly>::generate(f);	// 第 i 项为 f(i)
+ * 		auto C = (A * B + 3 * A).exp().inverse();
+ * 		C[i]								// 第 i 项
+ * 		C.prefix(n)							// 前 n 项 (Poly)
+ * 		C.precision()						// 当前已算出的项数
+ *
+ * Note:
+ * 		1. 倍增是增量的: inverse / exp 保存牛顿迭代的中间状态 (exp 同时保存 f^{-1})，
+ * 		   从当前精度继续迭代；ln 复用 inverse 结点；乘法每次重算截断乘积，
+ * 		   由于精度按 2 倍增长，总代价不超过直接算到最终精度的常数倍
+ * 		2. 约束同 Poly: inverse 要求常数项非 0，ln 要求常数项为 1，exp 要求常数项为 0，
+ * 		   pow 要求常数项非 0 (按 a_0^k exp(k ln(A / a_0)) 组合)
+ * 		3. 结点图必须无环；需要用自身定义自身 (如 f = 1 + x f^2) 时使用 RelaxedConvolution·在线卷积.cpp
+ */
+namespace poly_series {
+	template<typename P>
+	struct _Node {
+		using Core = typename P::Core;
+		std::vector<int> c;	// 已算出的前缀，长度为 0 或 2 的幂
+		virtual ~_Node() = default;
+		// 把 c 扩展到 n 项 (n 为 2 的幂且 n > c.size())
+		virtual void _grow(int n) = 0;
+		const int* ensure(int n) {
+			if ((int)c.size() < n) {
+				int t = std::max<int>(1, c.size());
+				while (t < n) t <<= 1;
+				_grow(t);
+			}
+			return c.data();
+		}
+	};
+
+	template<typename P>
+	struct Series {
+		using Core = typename P::Core;
+		using Ptr = std::shared_ptr<_Node<P>>;
+		Ptr p;
+
+		struct _Poly : _Node<P> {
+			P a;
+			_Poly(const P& a) : a(a) {}
+			void _grow(int n) override {
+				int o = this->c.size();
+				this->c.resize(n);
+				rep(i, o, std::min(n, (int)a.size()) - 1) this->c[i] = a[i];
+			}
+		};
+		struct _Gen : _Node<P> {
+			std::function<int(int)> f;
+			_Gen(std::function<int(int)> f) : f(std::move(f)) {}
+			void _grow(int n) override {
+				int o = this->c.size();
+				this->c.resize(n);
+				rep(i, o, n - 1) this->c[i] = f(i);
+			}
+		};
+		// ka A + kb B (b 可为空)，系数先约减到 [0, mod)
+		struct _Lin : _Node<P> {
+			Ptr a, b; int ka, kb;
+			_Lin(Ptr a, int ka, Ptr b, int kb) : a(a), b(b), ka((ka % Core::mod + Core::mod) % Core::mod), kb((kb % Core::mod + Core::mod) % Core::mod) {}
+			void _grow(int n) override {
+				int o = this->c.size();
+				const int* x = a->ensure(n);
+				const int* y = b ? b->ensure(n) : nullptr;
+				this->c.resize(n);
+				rep(i, o, n - 1) this->c[i] = y ? Core::add(Core::mul(ka, x[i]), Core::mul(kb, y[i])) : Core::mul(ka, x[i]);
+			}
+		};
+		struct _Mul : _Node<P> {
+			Ptr a, b;
+			_Mul(Ptr a, Ptr b) : a(a), b(b) {}
+			void _grow(int n) override {
+				const int* x = a->ensure(n);
+				const int* y = b->ensure(n);
+				typename Core::Arr t(2 * n - 1);
+				Core::mul(x, n, y, n, t);
+				this->c.assign(t.ptr, t.ptr + n);
+			}
+		};
+		struct _Inv : _Node<P> {
+			Ptr a;
+			_Inv(Ptr a) : a(a) {}
+			void _grow(int n) override {
+				auto& g = this->c;
+				if (g.empty()) g.push_back(Core::inv(a->ensure(1)[0]));
+				for (int h = g.size(); h < n; h <<= 1) {
+					const int* x = a->ensure(h << 1);
+					g.resize(h << 1);
+					Core::_inv_step(x, h << 1, g.data(), h);
+				}
+			}
+		};
+		// ln A = ∫ A' A^{-1}
+		struct _Ln : _Node<P> {
+			Ptr a, ia;
+			_Ln(Ptr a) : a(a), ia(std::make_shared<_Inv>(a)) {}
+			void _grow(int n) override {
+				int o = this->c.size();
+				this->c.resize(n);
+				if (n == 1) return;
+				const int* x = a->ensure(n);
+				const int* g = ia->ensure(n);
+				typename Core::Arr d(n - 1), t(2 * n - 3);
+				Core::deriv(x, n, d);
+				Core::mul(d, n - 1, g, n - 1, t);
+				Core::_prepare_ninv(n);
+				rep(i, std::max(o, 1), n - 1) this->c[i] = Core::mul(t[i - 1], Core::_ninv[i]);
+			}
+		};
+		struct _Exp : _Node<P> {
+			Ptr a;
+			std::vector<int> g;	// f^{-1} 的前 max(1, c.size() / 2) 项
+			_Exp(Ptr a) : a(a) {}
+			void _grow(int n) override {
+				auto& f = this->c;
+				if (f.empty()) f = {1}, g = {1};
+				for (int m = f.size(); m < n; m <<= 1) {
+					const int* x = a->ensure(m << 1);
+					f.resize(m << 1), g.resize(m);
+					Core::_exp_step(x, m << 1, f.data(), g.data(), m);
+				}
+			}
+		};
+
+		Series(const P& a = {}) : p(std::make_shared<_Poly>(a)) {}
+		Series(Ptr p) : p(std::move(p)) {}
+		// 第 i 项由 f(i) 给出，每项只调用一次，按下标递增的顺序调用
+		static Series generate(std::function<int(int)> f) { return Series(Ptr(std::make_shared<_Gen>(std::move(f)))); }
+
+		int operator[](int i) const { return p->ensure(i + 1)[i]; }
+		P prefix(int n) const { const int* x = p->ensure(n); return P(x, x + n); }
+		int precision() const { return p->c.size(); }
+
+		Series operator+(const Series& b) const { return Series(Ptr(std::make_shared<_Lin>(p, 1, b.p, 1))); }
+		Series operator-(const Series& b) const { return Series(Ptr(std::make_shared<_Lin>(p, 1, b.p, Core::mod - 1))); }
+		Series operator*(const Series& b) const { return Series(Ptr(std::make_shared<_Mul>(p, b.p))); }
+		Series operator*(int k) const { return Series(Ptr(std::make_shared<_Lin>(p, k, nullptr, 0))); }
+		friend Series operator*(int k, const Series& a) { return a * k; }
+
+		Series inverse() const { return Series(Ptr(std::make_shared<_Inv>(p))); }
+		Series ln() const { return Series(Ptr(std::make_shared<_Ln>(p))); }
+		Series exp() const { return Series(Ptr(std::make_shared<_Exp>(p))); }
+		// A^k = a_0^k exp(k ln(A / a_0))，要求 a_0 != 0 (取 a_0 时会计算第 0 项)
+		Series pow(i64 k) const {
+			int a0 = (*this)[0], md = Core::mod;
+			int e = (k % (md - 1) + md - 1) % (md - 1);
+			return ((*this * Core::inv(a0)).ln() * (int)((k % md + md) % md)).exp() * Core::fp(a0, e);
+		}
+	};
+} // namespace poly_series
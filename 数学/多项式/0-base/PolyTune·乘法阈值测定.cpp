@@ -0,0 +1,67 @@
+#include "aizalib.h"
+#include "PolyCore·多项式核心.hpp"
+
+/**
+ * PolyCore 乘法分派阈值测定 (micro-benchmark)
+ * 用法:
+ * 		以正式提交相同的编译选项 (如 -O2 -march=native) 在目标机器上编译运行，
+ * 		把最后输出的一行赋值放到程序开头，或直接改 PolyCore 中的默认值
+ * 测定内容:
+ * 		1. mul_naive_max: 长短悬殊 (n = 2048) 时朴素乘法快于 NTT 的最大短边
+ * 		2. mul_karatsuba_max: n = m 时朴素 / Karatsuba 快于 NTT 的最大长度
+ * 		3. mul_trunc_shift: 结果长度为 L + (L >> s) 时截断长度 NTT 快于普通 NTT 的最小 s
+ * Note:
+ * 		1. 每项取单次耗时 (微秒)，重复直到总时长超过 20ms
+ * 		2. 遇到第一个 NTT 更快的规模即停止，得到的阈值偏保守
+ */
+using Core = PolyCore<998244353, 3>;
+
+template<typename F>
+double bench(F&& f) {
+	for (int reps = 1; ; reps <<= 1) {
+		auto st = std::chrono::steady_clock::now();
+		rep(i, 1, reps) f();
+		double t = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - st).count();
+		if (t > 20000) return t / reps;
+	}
+}
+
+int main() {
+	std::mt19937 rng(20240601);
+	std::vector<int> a(1 << 14), b(1 << 14), res(1 << 15);
+	for (int& x : a) x = rng() % md;
+	for (int& x : b) x = rng() % md;
+
+	int naive_max = 0;
+	for (int m = 8; m <= 256; m += 8) {
+		double tn = bench([&] { Core::_mul_naive(a.data(), 2048, b.data(), m, res.data()); });
+		double tt = bench([&] { Core::_mul_ntt(a.data(), 2048, b.data(), m, res.data()); });
+		printf("naive  n = 2048, m = %4d: naive %9.2f us, ntt %9.2f us\n", m, tn, tt);
+		if (tn >= tt) break;
+		naive_max = m;
+	}
+	Core::mul_naive_max = naive_max;
+
+	int kara_max = naive_max;
+	for (int n = naive_max + 8; n <= 1024; n += 8) {
+		double ts = bench([&] { Core::_mul_small(a.data(), n, b.data(), n, res.data()); });
+		double tt = bench([&] { Core::_mul_ntt(a.data(), n, b.data(), n, res.data()); });
+		printf("small  n = m = %4d: small %9.2f us, ntt %9.2f us\n", n, ts, tt);
+		if (ts >= tt) break;
+		kara_max = n;
+	}
+	Core::mul_karatsuba_max = kara_max;
+
+	int trunc_shift = 30;
+	const int L = 4096;
+	per(s, 6, 1) {
+		int len = L + (L >> s), n = (len + 1) / 2, m = len + 1 - n;
+		double tc = bench([&] { Core::_mul_trunc(a.data(), n, b.data(), m, res.data()); });
+		double tt = bench([&] { Core::_mul_ntt(a.data(), n, b.data(), m, res.data()); });
+		printf("trunc  len = L + L >> %d: trunc %9.2f us, ntt %9.2f us\n", s, tc, tt);
+		if (tc >= tt) break;
+		trunc_shift = s;
+	}
+
+	printf("Core::mul_naive_max = %d, Core::mul_karatsuba_max = %d, Core::mul_trunc_shift = %d;\n", naive_max, kara_max, trunc_shift);
+}
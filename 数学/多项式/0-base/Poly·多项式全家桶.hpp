@@ -14,6 +14,7 @@
  * Interface:
  * 		Poly(vector)
  * 		+ - * / %
+ * 		Poly::mul_batch(as, bs)		// 批量乘法
  * 		deriv(), integral()
  * 		inverse(n), ln(n), exp(n)
  * 		sqrt(n), pow(k, n)
@@ -21,8 +22,10 @@
  * 
  * Note:
  * 		1. 继承自 std::vector<int>，可直接使用 vector 的方法
- * 		2. 内部使用静态内存池优化，减少内存分配开销
+ * 		2. 内部使用线程局部的分块内存池，减少内存分配开销，多线程各自独立
  * 		3. 注意创建常数 1，使用 Poly({1})，而不是 Poly(1)
+ * 		4. 运算符均立即求值；需要把一串 + - * % 合并到一次变换时使用 PolyLazy·多项式惰性表达式.hpp
+ * 		5. 截断长度事先未知、需要逐步取更高次项时使用 PolySeries·惰性幂级数.hpp
  * 
  * Inverse Note:
  * 		1. 需要保证常数项不为 0 (a[0] != 0)
@@ -79,6 +82,20 @@ struct Polynomial : public std::vector<int> {
 		return res;
 	}
 
+	// 批量乘法: res[i] = a[i] * b[i]，要求 a, b 组数相同；小规模乘法走朴素 / Karatsuba，同长度的 NTT 成组进行
+	static std::vector<Polynomial> mul_batch(const std::vector<Polynomial>& a, const std::vector<Polynomial>& b) {
+		AST(a.size() == b.size());
+		int cnt = a.size();
+		std::vector<Polynomial> res(cnt);
+		std::vector<typename Core::MulTask> ts(cnt);
+		rep(i, 0, cnt - 1) {
+			if (!a[i].empty() && !b[i].empty()) res[i].resize(a[i].size() + b[i].size() - 1);
+			ts[i] = {a[i].data(), (int)a[i].size(), b[i].data(), (int)b[i].size(), res[i].data()};
+		}
+		Core::mul_batch(ts.data(), cnt);
+		return res;
+	}
+
 	Polynomial operator*(int k) const {
 		Polynomial res = *this;
 		for (int& x : res) x = Core::mul(x, k);
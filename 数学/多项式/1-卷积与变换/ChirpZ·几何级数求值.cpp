@@ -0,0 +1,100 @@
+#include "0-base/Poly·多项式全家桶.hpp"
+
+namespace poly_ext {
+
+/**
+ * Chirp-Z 变换 (Bluestein): 在等比数列 c r^i (0 <= i < m) 上求值
+ * 原理:
+ * 		ij = C(i+j, 2) - C(i, 2) - C(j, 2)，于是
+ * 		f(c r^i) = r^{-C(i,2)} sum_j (f_j c^j r^{-C(j,2)}) r^{C(i+j,2)}
+ * 		求和是一个中间积，一次长度不小于 n + m - 1 的循环卷积即可得到 (回绕只污染用不到的低位)
+ * 复杂度: O((n + m) log(n + m))
+ *
+ * @param f 多项式 (n 项)
+ * @param c 首项
+ * @param r 公比 (r = 0 时退化为 f(c), f(0), f(0), ...)
+ * @param m 求值点数
+ * @return f(c), f(c r), ..., f(c r^{m-1})
+ */
+std::vector<int> chirp_z(const Poly& f, int c, int r, int m) {
+	int n = f.size();
+	std::vector<int> res(m);
+	if (!m || !n) return res;
+	if (r == 0) {
+		res[0] = f.eval(c);
+		rep(i, 1, m - 1) res[i] = f[0];
+		return res;
+	}
+	using Core = Poly::Core;
+	int ir = inv(r), len = n + m - 1, L = 1;
+	while (L < len) L <<= 1;
+	typename Core::Arr ta(L), tb(L);
+	ta.fill_zero(n, L);
+	// ta = rev(f_j c^j r^{-C(j,2)})，tb[t] = r^{C(t,2)}
+	for (int j = 0, cp = 1, q = 1, qs = 1; j < n; ++j) {
+		ta[n - 1 - j] = mul(f[j], mul(cp, q));
+		cp = mul(cp, c), q = mul(q, qs), qs = mul(qs, ir);
+	}
+	for (int t = 0, p = 1, ps = 1; t < len; ++t) tb[t] = p, p = mul(p, ps), ps = mul(ps, r);
+	tb.fill_zero(len, L);
+	Core::_dif(ta, L), Core::_dif(tb, L);
+	Core::_dot(ta, tb, L);
+	Core::_dit(ta, L);
+	for (int i = 0, q = 1, qs = 1; i < m; ++i) {
+		res[i] = mul(ta[n - 1 + i], q);
+		q = mul(q, qs), qs = mul(qs, ir);
+	}
+	return res;
+}
+
+/**
+ * Chirp-Z 逆变换: 已知 f(c r^i) = y_i (0 <= i < n)，求次数小于 n 的 f
+ * 要求 c != 0, r != 0，且 r^t != 1 (1 <= t < n)，即各点互不相同
+ * 原理 (x_i = c r^i, (r; r)_k = prod_{t=1}^{k} (1 - r^t)):
+ * 		1. M(x) = prod (x - x_i) = sum_k r^{C(k,2)} [n, k]_r (-c)^k x^{n-k}      (q-二项式定理)
+ * 		2. M'(x_i) = c^{n-1} (-1)^i r^{i(n-1) - C(i+1,2)} (r; r)_i (r; r)_{n-1-i}
+ * 		3. u_i = y_i / M'(x_i)，f = M sum u_i / (x - x_i)，在 0 处展开:
+ * 		   sum u_i / (x - x_i) = -sum_k s_k x^k，s_k = c^{-(k+1)} U(r^{-k})，U(z) = sum u_i r^{-i} z^i
+ * 		   s_k 由一次 chirp_z 得到，f = M S mod x^n
+ * 复杂度: O(n log n)
+ */
+Poly chirp_z_inverse(const std::vector<int>& y, int c, int r) {
+	int n = y.size();
+	if (!n) return Poly();
+	int ir = inv(r), ic = inv(c);
+	// rp[k] = r^k，qf[k] = (r; r)_k，iqf[k] = 1 / (r; r)_k (k < n)
+	std::vector<int> rp(n + 1), qf(n), iqf(n);
+	rp[0] = 1;
+	rep(k, 1, n) rp[k] = mul(rp[k - 1], r);
+	qf[0] = 1;
+	rep(k, 1, n - 1) qf[k] = mul(qf[k - 1], sub(1, rp[k]));
+	iqf[n - 1] = inv(qf[n - 1]);
+	per(k, n - 1, 1) iqf[k - 1] = mul(iqf[k], sub(1, rp[k]));
+
+	// M: [x^{n-k}] = r^{C(k,2)} [n, k]_r (-c)^k，[n, k]_r = [n, k-1]_r (1 - r^{n-k+1}) / (1 - r^k) (k < n)
+	Poly M(n + 1);
+	for (int k = 0, bin = 1, q = 1, nc = 1; k <= n; ++k) {
+		M[n - k] = mul(mul(k == n ? 1 : bin, q), nc);
+		if (k + 1 < n) bin = mul(mul(bin, sub(1, rp[n - k])), mul(iqf[k + 1], qf[k]));
+		q = mul(q, rp[k]), nc = mul(nc, sub(0, c));
+	}
+
+	// u_i r^{-i}，其中 1 / M'(x_i) = c^{-(n-1)} (-1)^i r^{C(i+1,2) - i(n-1)} / ((r; r)_i (r; r)_{n-1-i})
+	std::vector<int> u(n);
+	int icn = fp(ic, n - 1), irn = fp(ir, n - 1);
+	for (int i = 0, a = 1, b = 1, ri = 1; i < n; ++i) {
+		b = mul(b, rp[i]);	// b = r^{C(i+1,2)}，a = r^{-i(n-1)}，ri = r^{-i}
+		int w = mul(mul(icn, mul(a, b)), mul(iqf[i], iqf[n - 1 - i]));
+		if (i & 1) w = sub(0, w);
+		u[i] = mul(mul(y[i], w), ri);
+		a = mul(a, irn), ri = mul(ri, ir);
+	}
+	auto s = chirp_z(Poly(u), 1, ir, n);
+	Poly S(n);
+	for (int k = 0, cp = ic; k < n; ++k) S[k] = sub(0, mul(s[k], cp)), cp = mul(cp, ic);
+	Poly res = M * S;
+	res.resize(n);
+	return res;
+}
+
+} // namespace poly_ext
@@ -33,6 +33,7 @@ void cdq_framework(int n, F1 init_base, F2 relax) {
  *等价于 F(x) = C / (1 - G(x))
  * 
  * 复杂度: O(n log^2 n)
+ * 需要逐项在线推进 (事先不知道 n) 时使用 RelaxedConvolution·在线卷积.cpp
  * 
  * @param n 需要计算的项数，即计算 f[0]...f[n-1]
  * @param g 卷积多项式 g (要求 g[0] = 0), 确保没有自依赖
@@ -82,24 +83,22 @@ Poly cdq_ntt(int n, const Poly& g, int f_0 = 1) {
  * 计算 P = \prod P_i
  * 
  * 复杂度: O(N log^2 N)，其中 N 为所有多项式的度数之和
+ * 自底向上两两合并，同一层的乘法一次性交给 Poly::mul_batch (底层大量小乘法走朴素 / Karatsuba)
  * 
  * @param polys 多项式集合
  * @return 乘积多项式
  */
 Poly poly_prod(const std::vector<Poly>& polys) {
 	if (polys.empty()) return Poly({1});
-		
-	// 使用优先队列合并（哈夫曼树类似）或者直接分治
-	// 简单分治策略在多项式度数均匀时最优
-	// 这里实现简单的二分分治
-		
-	auto solve = [&](auto&& self, int l, int r) -> Poly {
-		if (l == r) return polys[l];
-		int mid = (l + r) >> 1;
-		return self(self, l, mid) * self(self, mid + 1, r);
-	};
-		
-	return solve(solve, 0, polys.size() - 1);
+	std::vector<Poly> cur = polys;
+	while (cur.size() > 1) {
+		std::vector<Poly> as, bs;
+		for (size_t i = 0; i + 1 < cur.size(); i += 2) as.push_back(std::move(cur[i])), bs.push_back(std::move(cur[i + 1]));
+		std::vector<Poly> nxt = Poly::mul_batch(as, bs);
+		if (cur.size() & 1) nxt.push_back(std::move(cur.back()));
+		cur = std::move(nxt);
+	}
+	return cur[0];
 }
 
 } // namespace poly_ext
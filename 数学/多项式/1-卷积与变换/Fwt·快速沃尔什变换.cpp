@@ -1,4 +1,7 @@
 #include "aizalib.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 namespace poly_ext {
 /**
  * 位运算卷积 / 快速沃尔什变换 (FWT) / 子集卷积
@@ -40,70 +43,132 @@ namespace poly_ext {
  *     4. XOR/XNOR 逆变换涉及除以 2, 用 inv(2)
  *     5. 索引 `i | len | j` 等价于 `i + len + j` (无进位, 因为 len 是单一位且 j < len)
  *        统一用 `|` 写法以强调 bitmask 语义
- *     6. subset_convolution 内部需要 O(K) 个长度 n 的数组, K 通常不超过 20
+ *     6. subset_convolution 内部需要 2(K + 1) 个长度 n 的 u32 数组 (K = 23 时约 1.6GB)
+ *     7. 实现: 数组按长 2^fwt_block_bits 切成行，低位各层在行内做完 (行常驻 L1)，
+ *        高位各层每 3 层合并为一趟整行运算；按 AVX-512 / AVX2 选择向量蝶形，否则退化为标量
+ *     8. n >= 2^18 时按行在 fwt_threads 个线程上并行 (多线程编译需 -pthread)
  */
 
-void fwt_or(std::vector<int>& a, int type) {
-	int n = (int)a.size();
-	for (int len = 1; len < n; len <<= 1) {
-		for (int i = 0; i < n; i += len << 1) {
-			rep(j, 0, len - 1) {
-				if (type == 1) a[i | len | j] = add(a[i | len | j], a[i | j]);
-				else a[i | len | j] = sub(a[i | len | j], a[i | j]);
-			}
-		}
+// 模加 / 模减 (u32，x, y 在 [0, md) 内): 溢出的一侧取 min 去掉
+inline u32 _fadd(u32 x, u32 y) { u32 s = x + y; return std::min(s, s - (u32)md); }
+inline u32 _fsub(u32 x, u32 y) { u32 d = x - y; return std::min(d, d + (u32)md); }
+#if defined(__AVX512F__)
+using _fvec = __m512i;
+inline _fvec _fadd(_fvec x, _fvec y) { _fvec s = _mm512_add_epi32(x, y); return _mm512_min_epu32(s, _mm512_sub_epi32(s, _mm512_set1_epi32(md))); }
+inline _fvec _fsub(_fvec x, _fvec y) { _fvec d = _mm512_sub_epi32(x, y); return _mm512_min_epu32(d, _mm512_add_epi32(d, _mm512_set1_epi32(md))); }
+inline _fvec _fload(const u32* p) { return _mm512_loadu_si512(p); }
+inline void _fstore(u32* p, _fvec v) { _mm512_storeu_si512(p, v); }
+#elif defined(__AVX2__)
+using _fvec = __m256i;
+inline _fvec _fadd(_fvec x, _fvec y) { _fvec s = _mm256_add_epi32(x, y); return _mm256_min_epu32(s, _mm256_sub_epi32(s, _mm256_set1_epi32(md))); }
+inline _fvec _fsub(_fvec x, _fvec y) { _fvec d = _mm256_sub_epi32(x, y); return _mm256_min_epu32(d, _mm256_add_epi32(d, _mm256_set1_epi32(md))); }
+inline _fvec _fload(const u32* p) { return _mm256_loadu_si256((const __m256i*)p); }
+inline void _fstore(u32* p, _fvec v) { _mm256_storeu_si256((__m256i*)p, v); }
+#endif
+
+// 各运算的蝶形: 对 x[0, n), y[0, n) 逐位作用，按向量宽度成组处理，余下的逐个处理
+// 逆变换的 XOR / XNOR 不在每层除以 2，最后统一乘 1/n
+template<int OP, int TYPE>
+inline void _fwt_bf(u32* x, u32* y, int n) {
+	auto bf = [](auto& u, auto& v) {
+		if constexpr (OP == 0) v = TYPE == 1 ? _fadd(v, u) : _fsub(v, u);
+		else if constexpr (OP == 1) u = TYPE == 1 ? _fadd(u, v) : _fsub(u, v);
+		else if constexpr (OP == 2) { auto t = u; u = _fadd(t, v), v = _fsub(t, v); }
+		else if constexpr (TYPE == 1) { auto t = u; u = _fadd(t, v), v = _fsub(v, t); }
+		else { auto t = u; u = _fsub(t, v), v = _fadd(t, v); }
+	};
+	int j = 0;
+#if defined(__AVX512F__) || defined(__AVX2__)
+	constexpr int W = sizeof(_fvec) / 4;
+	for (; j + W <= n; j += W) {
+		_fvec u = _fload(x + j), v = _fload(y + j);
+		bf(u, v);
+		_fstore(x + j, u), _fstore(y + j, v);
 	}
+#endif
+	for (; j < n; ++j) bf(x[j], y[j]);
 }
 
-void fwt_and(std::vector<int>& a, int type) {
-	int n = (int)a.size();
-	for (int len = 1; len < n; len <<= 1) {
-		for (int i = 0; i < n; i += len << 1) {
-			rep(j, 0, len - 1) {
-				if (type == 1) a[i | j] = add(a[i | j], a[i | len | j]);
-				else a[i | j] = sub(a[i | j], a[i | len | j]);
-			}
-		}
+// 秩卷积的乘加: acc += x * y (u64)，向量版本把每组 W 个数的偶 / 奇位分开存放，
+// 第 j 个数的累加值位于 acc[_acc_pos(j, L)]，不足一组的尾部按原位置逐个处理
+#if defined(__AVX512F__) || defined(__AVX2__)
+inline int _acc_pos(int j, int L) {
+	constexpr int W = sizeof(_fvec) / 4;
+	return j >= (L & -W) ? j : (j & -W) | (j & 1) * (W / 2) | (j & (W - 1)) >> 1;
+}
+inline void _rank_fma(u64* acc, const u32* x, const u32* y, int L) {
+	constexpr int W = sizeof(_fvec) / 4;
+	int j = 0;
+	for (; j + W <= L; j += W) {
+		_fvec a = _fload(x + j), b = _fload(y + j);
+#if defined(__AVX512F__)
+		_fvec e = _mm512_mul_epu32(a, b), o = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+		_mm512_storeu_si512(acc + j, _mm512_add_epi64(_mm512_loadu_si512(acc + j), e));
+		_mm512_storeu_si512(acc + j + W / 2, _mm512_add_epi64(_mm512_loadu_si512(acc + j + W / 2), o));
+#else
+		_fvec e = _mm256_mul_epu32(a, b), o = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+		_mm256_storeu_si256((__m256i*)(acc + j), _mm256_add_epi64(_mm256_loadu_si256((__m256i*)(acc + j)), e));
+		_mm256_storeu_si256((__m256i*)(acc + j + W / 2), _mm256_add_epi64(_mm256_loadu_si256((__m256i*)(acc + j + W / 2)), o));
+#endif
 	}
+	for (; j < L; ++j) acc[j] += (u64)x[j] * y[j];
 }
+#else
+inline int _acc_pos(int j, int) { return j; }
+inline void _rank_fma(u64* acc, const u32* x, const u32* y, int L) { rep(j, 0, L - 1) acc[j] += (u64)x[j] * y[j]; }
+#endif
 
-void fwt_xor(std::vector<int>& a, int type) {
-	int n = (int)a.size();
-	int inv2 = inv(2);
-	for (int len = 1; len < n; len <<= 1) {
-		for (int i = 0; i < n; i += len << 1) {
-			rep(j, 0, len - 1) {
-				int u = a[i | j], v = a[i | len | j];
-				a[i | j] = add(u, v);
-				a[i | len | j] = sub(u, v);
-				if (type == -1) {
-					a[i | j] = mul(a[i | j], inv2);
-					a[i | len | j] = mul(a[i | len | j], inv2);
-				}
-			}
-		}
-	}
+inline int fwt_threads = std::max(1u, std::thread::hardware_concurrency());
+inline int fwt_block_bits = 12;	// 行长 2^12 个 int (16KB)，低位各层在行内完成
+
+// 在 [0, cnt) 上按连续区间切分并行执行 f(i)，总量较小时不开线程
+template<typename F>
+void _fwt_parallel_for(int cnt, i64 work, F&& f) {
+	int t = work < (1 << 18) ? 1 : std::max(1, std::min(fwt_threads, cnt));
+	auto run = [&](int k) { for (int i = 1ll * cnt * k / t, e = 1ll * cnt * (k + 1) / t; i < e; ++i) f(i); };
+	std::vector<std::thread> ths;
+	rep(k, 1, t - 1) ths.emplace_back(run, k);
+	run(0);
+	for (auto& th : ths) th.join();
 }
 
-void fwt_xnor(std::vector<int>& a, int type) {
-	int n = (int)a.size();
-	int inv2 = inv(2);
-	for (int len = 1; len < n; len <<= 1) {
-		for (int i = 0; i < n; i += len << 1) {
-			rep(j, 0, len - 1) {
-				int u = a[i | j], v = a[i | len | j];
-				if (type == 1) {
-					a[i | j] = add(u, v);
-					a[i | len | j] = sub(v, u);
-				} else {
-					a[i | j] = mul(sub(u, v), inv2);
-					a[i | len | j] = mul(add(u, v), inv2);
-				}
-			}
-		}
+// 长为 L 的连续数组上的完整变换 (低位各层)
+template<int OP, int TYPE>
+void _fwt_low(u32* a, int L) {
+	for (int len = 1; len < L; len <<= 1)
+		for (int i = 0; i < L; i += len << 1) _fwt_bf<OP, TYPE>(a + i, a + i + len, len);
+}
+
+// 跨行的高位各层: 第 (blk, r) 行位于 a + (blk * ranks + r) * L，对 blk 的 hb 个二进制位做变换
+// 每次取出 3 个相邻高位对应的 8 行，三层在这 8 行上连续做完，内存只扫一遍
+template<int OP, int TYPE>
+void _fwt_high(u32* a, int hb, int ranks, int L) {
+	for (int s = 0; s < hb; s += 3) {
+		int t = std::min(3, hb - s), outer = (1 << hb) >> t;
+		_fwt_parallel_for(outer * ranks, (i64)L * ranks << hb, [&](int id) {
+			int o = id / ranks, r = id % ranks;
+			int base = ((o >> s) << (s + t)) | (o & ((1 << s) - 1));
+			u32* row[8];
+			rep(i, 0, (1 << t) - 1) row[i] = a + ((size_t)(base | i << s) * ranks + r) * L;
+			rep(l, 0, t - 1) rep(i, 0, (1 << t) - 1) if (!(i >> l & 1)) _fwt_bf<OP, TYPE>(row[i], row[i | 1 << l], L);
+		});
 	}
 }
 
+template<int OP, int TYPE>
+void _fwt(std::vector<int>& v) {
+	int n = (int)v.size(), K = std::__lg(std::max(n, 1)), b = std::min(K, fwt_block_bits), L = 1 << b;
+	u32* a = (u32*)v.data();
+	_fwt_parallel_for(n >> b, n, [&](int i) { _fwt_low<OP, TYPE>(a + (size_t)i * L, L); });
+	_fwt_high<OP, TYPE>(a, K - b, 1, L);
+	if (OP >= 2 && TYPE == -1) { int in = inv(n); for (int& x : v) x = mul(x, in); }
+}
+
+void fwt_or(std::vector<int>& a, int type) { type == 1 ? _fwt<0, 1>(a) : _fwt<0, -1>(a); }
+void fwt_and(std::vector<int>& a, int type) { type == 1 ? _fwt<1, 1>(a) : _fwt<1, -1>(a); }
+void fwt_xor(std::vector<int>& a, int type) { type == 1 ? _fwt<2, 1>(a) : _fwt<2, -1>(a); }
+void fwt_xnor(std::vector<int>& a, int type) { type == 1 ? _fwt<3, 1>(a) : _fwt<3, -1>(a); }
+
 std::vector<int> or_convolution(const std::vector<int>& a, const std::vector<int>& b) {
 	int n = (int)a.size();
 	auto fa = a, fb = b;
@@ -140,38 +205,56 @@ std::vector<int> xor_convolution(const std::vector<int>& a, const std::vector<in
  * 按 popcount 分层: f[c][mask] 记 popcount(mask) == c 时的 a[mask], 否则为 0
  * 对每层做 fwt_or, 在变换域做卷积 (h[c] = sum_{d} f[d] * g[c-d]), 再 fwt_or 逆变换
  * 取 res[mask] = h[popcount(mask)][mask] 即筛掉 i & j != 0 的贡献
+ * 存储 (SoA): mask 拆成 (blk, low)，低 b 位为行内下标，f 存为 [blk][rank][low]
+ * 		1. 低位 zeta 在每个 blk 的 (K + 1) x 2^b 小块内完成，整块常驻缓存
+ * 		2. 高位 zeta 为整行相加 (_fwt_high)，三层合并扫一遍
+ * 		3. 秩卷积在同一块内按 low 向量化，u64 累加每 8 项取模一次；
+ * 		   f[d][mask] 只在 d <= popcount(mask) 时非零，d 的范围按块内最大 popcount 收紧
+ * 		4. h 直接写回 f，额外空间只有 g
  */
+inline int subset_block_bits = 10;
+
 std::vector<int> subset_convolution(const std::vector<int>& a, const std::vector<int>& b) {
-	int n = (int)a.size();
-	int K = 0;
-	while ((1 << K) < n) ++K;
-	std::vector f(K + 1, std::vector<int>(n, 0));
-	std::vector g(K + 1, std::vector<int>(n, 0));
-	rep(mask, 0, n - 1) {
-		int pc = std::popcount((unsigned)mask);
-		f[pc][mask] = a[mask];
-		g[pc][mask] = b[mask];
-	}
-	rep(c, 0, K) {
-		fwt_or(f[c], 1);
-		fwt_or(g[c], 1);
-	}
-	std::vector h(K + 1, std::vector<int>(n, 0));
-	rep(c, 0, K) {
-		rep(d, 0, c) {
-			rep(mask, 0, n - 1) {
-				h[c][mask] = add(h[c][mask], mul(f[d][mask], g[c - d][mask]));
+	int n = (int)a.size(), K = std::__lg(std::max(n, 1)), R = K + 1;
+	int bb = std::min(K, subset_block_bits), L = 1 << bb, nb = n >> bb;
+	std::vector<u32> f((size_t)R * n), g((size_t)R * n);
+	auto at = [&](std::vector<u32>& v, int blk, int r) { return v.data() + ((size_t)blk * R + r) * L; };
+	_fwt_parallel_for(nb, (i64)R * n, [&](int blk) {
+		int pb = std::popcount((unsigned)blk);
+		rep(low, 0, L - 1) {
+			int r = pb + std::popcount((unsigned)low), m = blk << bb | low;
+			at(f, blk, r)[low] = a[m], at(g, blk, r)[low] = b[m];
+		}
+		rep(r, pb, std::min(K, pb + bb)) _fwt_low<0, 1>(at(f, blk, r), L), _fwt_low<0, 1>(at(g, blk, r), L);
+	});
+	_fwt_high<0, 1>(f.data(), K - bb, R, L);
+	_fwt_high<0, 1>(g.data(), K - bb, R, L);
+	_fwt_parallel_for(nb, (i64)R * R * n, [&](int blk) {
+		// 块内 popcount 不超过 hi，f[d] 在 d > hi 时为 0
+		int hi = std::popcount((unsigned)blk) + bb;
+		std::vector<u64> acc(L);
+		per(c, std::min(K, 2 * hi), 0) {
+			std::fill(acc.begin(), acc.end(), 0);
+			int lo = std::max(0, c - hi), up = std::min(c, hi);
+			for (int d = lo; d <= up; ) {
+				for (int e = std::min(up + 1, d + 8); d < e; ++d) {
+					_rank_fma(acc.data(), at(f, blk, d), at(g, blk, c - d), L);
+				}
+				for (u64& s : acc) s %= md;
 			}
+			// 从高到低写回: f[c] 被覆盖时 c 以上的 h 已算完，且之后只用到 f[d] (d <= c)
+			u32* h = at(f, blk, c);
+			rep(j, 0, L - 1) h[j] = acc[_acc_pos(j, L)];
 		}
-	}
-	rep(c, 0, K) {
-		fwt_or(h[c], -1);
-	}
-	std::vector<int> res(n, 0);
-	rep(mask, 0, n - 1) {
-		int pc = std::popcount((unsigned)mask);
-		res[mask] = h[pc][mask];
-	}
+	});
+	std::vector<u32>().swap(g);
+	_fwt_high<0, -1>(f.data(), K - bb, R, L);
+	std::vector<int> res(n);
+	_fwt_parallel_for(nb, (i64)R * n, [&](int blk) {
+		int pb = std::popcount((unsigned)blk);
+		rep(r, pb, std::min(K, pb + bb)) _fwt_low<0, -1>(at(f, blk, r), L);
+		rep(low, 0, L - 1) res[blk << bb | low] = at(f, blk, pb + std::popcount((unsigned)low))[low];
+	});
 	return res;
 }
 
@@ -1,5 +1,6 @@
 #include "aizalib.h"
 #include "../0-base/PolyCore·多项式核心.hpp"
+#include "../../数论/FastMod·快速取模.hpp"
 
 /**
  * MTT (CRT 结果合并 - 纯整数域)
@@ -46,12 +47,13 @@ namespace MTT_CRT {
 		std::vector<int> ans(len);
 		i64 m1_mod_p = m1 % p;
 		i64 m1m2_mod_p = 1ll * m1 * m2 % p;
+		Barrett32 br(p);
 
 		rep(i, 0, len - 1) {
 			i64 v1 = r1[i];
 			i64 v2 = (i64)(r2[i] - v1 + m2) % m2 * inv1_m2 % m2;
 			i64 v3 = (i64)(r3[i] - (v1 + v2 * m1) % m3 + m3) % m3 * inv12_m3 % m3;
-			ans[i] = (v1 + v2 * m1_mod_p + v3 * m1m2_mod_p) % p;
+			ans[i] = br.reduce(v1 + v2 * m1_mod_p + v3 * m1m2_mod_p);
 		}
 		return ans;
 	}
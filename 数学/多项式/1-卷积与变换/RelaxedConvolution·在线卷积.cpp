@@ -0,0 +1,84 @@
+#include "0-base/Poly·多项式全家桶.hpp"
+
+namespace poly_ext {
+
+/**
+ * 在线卷积 (Relaxed Multiplication)
+ * 逐项输入 f_p, g_p，立即返回 h_p = sum_{i+j = p} f_i g_j，无需预先知道总长度
+ *
+ * 原理 (按 1-base 下标 J = i + 1, K = j + 1 对 (J, K) 平面做二进制分块):
+ * 		对角块 [w, 2w) x [w, 2w): 在 p = 2w - 2 时一次算出
+ * 		非对角块 [w, 2w) x [cw, (c+1)w) (c >= 2) 及其对称块: 在 p = (c+1)w - 2 时算出
+ * 		每块所需的输入恰在该步全部已知，而其贡献的最低次项恰为 h_p，因此不会迟到
+ * 		固定的一侧 f[w-1, 2w-1), g[w-1, 2w-1) 的 NTT 点值按 w 缓存，每个非对角块只需 2 次正变换 + 1 次逆变换
+ * 		宽度不超过 Core::mul_naive_max 的小块直接朴素计算
+ *
+ * 复杂度: 前 n 项总计 O(n log^2 n)
+ *
+ * 用法 (半在线卷积 f_n = sum_{i<n} f_i g_{n-i}, 与 cdq_ntt 等价):
+ * 		令 a_i = f_i, b_i = g_{i+1}，则 f_n = (a * b)_{n-1}
+ * 		f[0] = f_0; rep(n, 1, N - 1) f[n] = rc.push(f[n - 1], g[n]);
+ */
+struct RelaxedConvolution {
+	using Core = Poly::Core;
+	std::vector<int> f, g, h;
+	std::vector<std::vector<int>> tf, tg;	// tf[z] / tg[z]: f / g 在 [w-1, 2w-1) 上的 2w 点 DIF 点值 (w = 2^z)
+
+	int size() const { return f.size(); }
+
+	// 输入 f_p, g_p (p 为已输入的项数)，返回 h_p
+	int push(int fp, int gp) {
+		int p = f.size();
+		f.push_back(fp), g.push_back(gp);
+		if ((int)h.size() < 2 * p + 1) h.resize(std::max(2 * p + 1, (int)h.size() * 2));
+		for (int w = 1, z = 0; (p + 2) % w == 0 && 2 * w <= p + 2; w <<= 1, ++z) {
+			if (p + 2 == 2 * w) _diag(w, z);
+			else _tile(p, w, z);
+		}
+		return h[p];
+	}
+
+	// 对角块: f[w-1, 2w-1) * g[w-1, 2w-1) 加到 h[2w-2, 4w-3)
+	void _diag(int w, int z) {
+		int *a = f.data() + w - 1, *b = g.data() + w - 1, *out = h.data() + 2 * w - 2;
+		if (w <= Core::mul_naive_max) {
+			typename Core::Arr t(2 * w - 1);
+			Core::_mul_naive(a, w, b, w, t);
+			rep(i, 0, 2 * w - 2) out[i] = Core::add(out[i], t[i]);
+			return;
+		}
+		if ((int)tf.size() <= z) tf.resize(z + 1), tg.resize(z + 1);
+		tf[z].assign(2 * w, 0), tg[z].assign(2 * w, 0);
+		std::copy(a, a + w, tf[z].begin()), std::copy(b, b + w, tg[z].begin());
+		Core::_dif(tf[z].data(), 2 * w), Core::_dif(tg[z].data(), 2 * w);
+		typename Core::Arr t(2 * w);
+		t.copy_from(tf[z].data(), 2 * w);
+		Core::_dot(t, tg[z].data(), 2 * w);
+		Core::_dit(t, 2 * w);
+		rep(i, 0, 2 * w - 2) out[i] = Core::add(out[i], t[i]);
+	}
+
+	// 非对角块: f[w-1, 2w-1) * g[p-w+1, p] + g[w-1, 2w-1) * f[p-w+1, p] 加到 h[p, p+2w-1)
+	void _tile(int p, int w, int z) {
+		const int *fa = f.data() + w - 1, *gb = g.data() + p - w + 1;
+		const int *ga = g.data() + w - 1, *fb = f.data() + p - w + 1;
+		int* out = h.data() + p;
+		if (w <= Core::mul_naive_max) {
+			typename Core::Arr t1(2 * w - 1), t2(2 * w - 1);
+			Core::_mul_naive(fa, w, gb, w, t1);
+			Core::_mul_naive(ga, w, fb, w, t2);
+			rep(i, 0, 2 * w - 2) out[i] = Core::add(out[i], Core::add(t1[i], t2[i]));
+			return;
+		}
+		typename Core::Arr t1(2 * w), t2(2 * w);
+		t1.copy_from(gb, w), t1.fill_zero(w, 2 * w);
+		t2.copy_from(fb, w), t2.fill_zero(w, 2 * w);
+		Core::_dif(t1, 2 * w), Core::_dif(t2, 2 * w);
+		Core::_dot(t1, tf[z].data(), 2 * w), Core::_dot(t2, tg[z].data(), 2 * w);
+		rep(i, 0, 2 * w - 1) t1[i] = Core::add(t1[i], t2[i]);
+		Core::_dit(t1, 2 * w);
+		rep(i, 0, 2 * w - 2) out[i] = Core::add(out[i], t1[i]);
+	}
+};
+
+} // namespace poly_ext
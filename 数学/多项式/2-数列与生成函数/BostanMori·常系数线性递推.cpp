@@ -8,12 +8,57 @@ namespace poly_ext {
  * 模板参数: 无
  * Interface: 
  *  - bostan_mori(n, P, Q): 求 [x^n] P(x)/Q(x)
+ *  - bostan_mori_batch(ns, P, Q): 同一分式的多个 n 一起求
  *  - linear_recurrence(n, c, a): 求常系数线性递推数列第 n 项
+ *  - linear_recurrence_batch(ns, c, a): 同一递推的多个 n 一起求
  * Note:
  * 		1. Time: O(d log d log n), d = deg(Q)
- * 		2. Space: O(d)
+ * 		2. Space: O(d)；批量版本额外缓存 Q 每一层的点值，O(d log n)
+ * 		3. P, Q 全程以 2N 点的 NTT 点值 (_dif 的位逆序) 保存，不回到系数:
+ * 		   位逆序下相邻的 (2k, 2k+1) 两个位置恰为 x 与 -x，Q(-x) 的点值直接交换相邻项得到，
+ * 		   取偶 / 奇部分只需逐点运算，得到的 N 项恰为 N 点 NTT 的位逆序点值；
+ * 		   再把 N 点点值倍增回 2N 点 (一次 N 点逆变换 + 一次 N 点正变换)，每轮共 4 次 N 点变换
+ * 		4. 批量查询时 Q 的各层与 n 无关，只算一次，每个 n 每轮只需处理 P (2 次 N 点变换)
  */
 
+struct BostanMoriImpl {
+	using Core = Poly::Core;
+	int N;
+	std::vector<int> hx, dw;	// hx[k] = 1 / (2 x_k)，x_k 为位逆序第 2k 个位置的点；dw[i] = w_{2N}^i
+
+	BostanMoriImpl(int N) : N(N), hx(N), dw(N) {
+		int w = Core::fp(Core::g, (Core::mod - 1) / (2 * N)), iw = Core::inv(w), inv2 = Core::inv(2);
+		dw[0] = 1;
+		rep(i, 1, N - 1) dw[i] = Core::mul(dw[i - 1], w);
+		std::vector<int> ipw(N, inv2);
+		rep(i, 1, N - 1) ipw[i] = Core::mul(ipw[i - 1], iw);
+		rep(k, 0, N - 1) {
+			int r = 0;
+			for (int b = 1, t = k; b < N; b <<= 1, t >>= 1) r = r << 1 | (t & 1);
+			hx[k] = ipw[r];
+		}
+	}
+
+	// 2N 点的 P(x) Q(-x) 取偶 (odd = 0) / 奇 (odd = 1) 部分，结果为 N 点，可原位
+	void halve(int* p, const int* q, int odd) const {
+		int inv2 = (Core::mod + 1) / 2;
+		rep(k, 0, N - 1) {
+			int a = Core::mul(p[2 * k], q[2 * k + 1]), b = Core::mul(p[2 * k + 1], q[2 * k]);
+			p[k] = odd ? Core::mul(Core::sub(a, b), hx[k]) : Core::mul(Core::add(a, b), inv2);
+		}
+	}
+	// 2N 点的 Q(x) Q(-x)，结果为 N 点，可原位
+	void halve_q(int* q) const { rep(k, 0, N - 1) q[k] = Core::mul(q[2 * k], q[2 * k + 1]); }
+	// a[0, N) 为 N 点点值，补出 a[N, 2N) (奇数次单位根上的点值)
+	void twice(int* a) const {
+		std::copy(a, a + N, a + N);
+		Core::_dit(a + N, N);
+		Core::_dot(a + N, dw.data(), N);
+		Core::_dif(a + N, N);
+	}
+	static int sum(const int* a, int n) { int s = 0; rep(i, 0, n - 1) s = Core::add(s, a[i]); return s; }
+};
+
 /**
  * @brief Bostan-Mori 算法求 [x^n] P(x)/Q(x)
  * @param n 求第 n 项的系数 (0-indexed)
@@ -21,26 +66,57 @@ namespace poly_ext {
  * @param Q 分母多项式 (需要保证 Q[0] != 0)
  * @return [x^n] P(x)/Q(x) 取模后的值
  */
-int bostan_mori(i64 n, Poly P, Poly Q) {
-	while (n > 0) {
-		auto Q_neg = Q;
-		for (int i = 1; i < (int)Q_neg.size(); i += 2)
-			Q_neg[i] = sub(0, Q_neg[i]);
-
-		auto U = P * Q_neg, V = Q * Q_neg;
-		
-		P.clear();
-		for (int i = (n & 1); i < (int)U.size(); i += 2)
-			P.push_back(U[i]);
-
-		Q.clear();
-		for (int i = 0; i < (int)V.size(); i += 2)
-			Q.push_back(V[i]);
+int bostan_mori(i64 n, const Poly& P, const Poly& Q) {
+	using Core = Poly::Core;
+	if (P.empty() || Q.empty() || Q[0] == 0) return 0;
+	if (n == 0) return Core::mul(P[0], Core::inv(Q[0]));
+	int N = 1; while (N < (int)std::max(P.size(), Q.size())) N <<= 1;
+	BostanMoriImpl bm(N);
+	std::vector<int> p(2 * N), q(2 * N);
+	std::copy(P.begin(), P.end(), p.begin()), std::copy(Q.begin(), Q.end(), q.begin());
+	Core::_dif(p.data(), 2 * N), Core::_dif(q.data(), 2 * N);
+	while (true) {
+		bm.halve(p.data(), q.data(), n & 1), bm.halve_q(q.data());
+		if (!(n >>= 1)) return Core::mul(bm.sum(p.data(), N), Core::inv(bm.sum(q.data(), N)));
+		bm.twice(p.data()), bm.twice(q.data());
+	}
+}
 
-		n >>= 1;
+/**
+ * @brief 批量求 [x^{n_i}] P(x)/Q(x)
+ * Q 的逐层点值与 n 无关，预先算好供所有查询共用
+ */
+std::vector<int> bostan_mori_batch(const std::vector<i64>& ns, const Poly& P, const Poly& Q) {
+	using Core = Poly::Core;
+	std::vector<int> res(ns.size());
+	if (P.empty() || Q.empty() || Q[0] == 0 || ns.empty()) return res;
+	int N = 1; while (N < (int)std::max(P.size(), Q.size())) N <<= 1;
+	int lv = 0;
+	for (i64 n : ns) lv = std::max(lv, 64 - __builtin_clzll(std::max<i64>(n, 1)));
+	BostanMoriImpl bm(N);
+	std::vector<int> p0(2 * N), iqs(lv);
+	std::vector<std::vector<int>> qs(lv, std::vector<int>(2 * N));
+	std::copy(P.begin(), P.end(), p0.begin()), std::copy(Q.begin(), Q.end(), qs[0].begin());
+	Core::_dif(p0.data(), 2 * N), Core::_dif(qs[0].data(), 2 * N);
+	rep(t, 0, lv - 1) {
+		std::vector<int> h(qs[t].begin(), qs[t].end());
+		bm.halve_q(h.data());
+		iqs[t] = Core::inv(bm.sum(h.data(), N));
+		if (t + 1 < lv) std::copy(h.begin(), h.begin() + N, qs[t + 1].begin()), bm.twice(qs[t + 1].data());
+	}
+	std::vector<int> p(2 * N);
+	int ip0 = Core::mul(P[0], Core::inv(Q[0]));
+	rep(i, 0, (int)ns.size() - 1) {
+		i64 n = ns[i];
+		if (n == 0) { res[i] = ip0; continue; }
+		std::copy(p0.begin(), p0.end(), p.begin());
+		for (int t = 0; ; ++t) {
+			bm.halve(p.data(), qs[t].data(), n & 1);
+			if (!(n >>= 1)) { res[i] = Core::mul(bm.sum(p.data(), N), iqs[t]); break; }
+			bm.twice(p.data());
+		}
 	}
-	if (Q.empty() || Q[0] == 0) return 0;
-	return mul(P.empty() ? 0 : P[0], inv(Q[0]));
+	return res;
 }
 
 /**
@@ -52,13 +128,14 @@ int bostan_mori(i64 n, Poly P, Poly Q) {
  * @return a_n 取模后的值
  */
 int linear_recurrence(long long n, const std::vector<int>& c, const std::vector<int>& a) {
+	using Core = Poly::Core;
 	int d = c.size();
 	if (n < d) return a[n];
 
 	Poly Q(d + 1);
 	Q[0] = 1;
 	rep(i, 0, d - 1)
-		Q[i + 1] = sub(0, c[i]);
+		Q[i + 1] = Core::sub(0, c[i]);
 
 	Poly A(a);
 	auto P = A * Q;
@@ -67,4 +144,27 @@ int linear_recurrence(long long n, const std::vector<int>& c, const std::vector<
 	return bostan_mori(n, P, Q);
 }
 
+/**
+ * @brief 批量求线性递推数列的第 n_i 项，参数同 linear_recurrence
+ */
+std::vector<int> linear_recurrence_batch(const std::vector<i64>& ns, const std::vector<int>& c, const std::vector<int>& a) {
+	using Core = Poly::Core;
+	int d = c.size();
+	Poly Q(d + 1);
+	Q[0] = 1;
+	rep(i, 0, d - 1)
+		Q[i + 1] = Core::sub(0, c[i]);
+
+	Poly A(a);
+	auto P = A * Q;
+	P.resize(d);
+
+	std::vector<i64> big;
+	for (i64 n : ns) if (n >= d) big.push_back(n);
+	auto vals = bostan_mori_batch(big, P, Q);
+	std::vector<int> res(ns.size());
+	for (int i = 0, j = 0; i < (int)ns.size(); ++i) res[i] = ns[i] < d ? a[ns[i]] : vals[j++];
+	return res;
+}
+
 } // namespace poly_ext
@@ -0,0 +1,120 @@
+#include "aizalib.h"
+#include "0-base/Poly·多项式全家桶.hpp"
+
+/**
+ * 多项式复合 / 复合逆 (Kinoshita-Li)
+ * 算法介绍:
+ * 		幂投影: a_i = sum_j w_j [x^j] g^i = [x^{n-1}] rev(w)(x) / (1 - y g(x)) 的 y^i 系数
+ * 			Graeffe 迭代: P / Q = P(x, y) Q(-x, y) / V(x^2, y)，V = Q(x, y) Q(-x, y)，
+ * 			只保留分子中与 x^{n-1} 同奇偶的部分，x 的长度减半、y 的次数翻倍，
+ * 			x 长度为 1 时只剩 y 的一元分式，一次求逆即可
+ * 		复合: f(g) = [y^{m-1}] rev(f)(y) / (1 - y g(x)) mod x^n，为幂投影的转置
+ * 			自顶向下只对分母做 Graeffe 迭代并保存每层的 Q；
+ * 			第 d 层只需要 rev(f) / Q_d 在 y 次数 [m - K_d, m) 的窗口 (K_0 = 1, K_{d+1} = K_d + deg_y Q_d)，
+ * 			最底层一元求逆得到窗口，再由 1 / Q_d = Q_d(-x, y) (1 / Q_{d+1})(x^2, y) 逐层向上还原
+ * 		复合逆: f(g) = x，由拉格朗日反演 [x^{n-1}] f^i = i / (n-1) [x^{n-1-i}] (x / g)^{n-1}，
+ * 			一次幂投影得到 (x / g)^{n-1}，开 n-1 次方再求逆
+ * 		每层的二元多项式乘法按 a[x * Y + y] 展平为一元乘法 (Kronecker 代换)
+ *
+ * Interface:
+ * 		std::vector<int> power_projection(w, g, m);	// a_i = sum_j w_j [x^j] g^i (0 <= i < m)
+ * 		Poly compose(f, g, n);							// f(g(x)) mod x^n
+ * 		Poly compositional_inverse(f, n);				// g 满足 f(g(x)) = x mod x^n，要求 f[0] = 0, f[1] != 0
+ *
+ * Note:
+ * 		1. Time: O(n log^2 n) (m = O(n))
+ * 		2. Space: 幂投影 O(n)；复合保存每层的 Q，O(n log n)
+ * 		3. g[0] 不必为 0: 1 / (1 - y g) 按 y 的形式幂级数理解，Q(0, y) = 1 - g_0 y 可逆
+ */
+
+namespace poly_ext {
+
+// 展平的二元多项式 a (x 长 nx，y 长 ya) 写入 y 步长为 Y 的数组，sgn 为真时取 a(-x, y)
+inline Poly _kron(const Poly& a, int nx, int ya, int Y, bool sgn = false) {
+	Poly r(nx * Y);
+	rep(x, 0, nx - 1) rep(y, 0, ya - 1) r[x * Y + y] = (sgn && (x & 1)) ? sub(0, a[x * ya + y]) : a[x * ya + y];
+	return r;
+}
+
+std::vector<int> power_projection(const Poly& w, const Poly& g, int m) {
+	int n = w.size();
+	std::vector<int> res(m);
+	if (!n || !m) return res;
+	// P: x 长 N，y 长 dp；Q: x 长 N，y 长 dq (y 的次数只需要小于 m)
+	int N = n, dp = 1, dq = std::min(2, m);
+	Poly P(n), Q(n * dq);
+	rep(j, 0, n - 1) P[j] = w[n - 1 - j];
+	Q[0] = 1;
+	if (dq == 2) rep(x, 0, std::min(n, (int)g.size()) - 1) Q[x * 2 + 1] = sub(0, g[x]);
+	while (N > 1) {
+		int Y = std::max(dp, dq) + dq - 1, odd = (N - 1) & 1, N2 = (N - 1) / 2 + 1;
+		int ep = std::min(dp + dq - 1, m), eq = std::min(2 * dq - 1, m);
+		Poly C = _kron(Q, N, dq, Y, true);
+		Poly U = _kron(P, N, dp, Y) * C, V = _kron(Q, N, dq, Y) * C;
+		P.assign(N2 * ep, 0), Q.assign(N2 * eq, 0);
+		rep(x, 0, N2 - 1) {
+			rep(y, 0, ep - 1) P[x * ep + y] = U[(2 * x + odd) * Y + y];
+			rep(y, 0, eq - 1) Q[x * eq + y] = V[2 * x * Y + y];
+		}
+		N = N2, dp = ep, dq = eq;
+	}
+	Poly r = Poly(P) * Poly(Q).inverse(m);
+	rep(i, 0, std::min(m, (int)r.size()) - 1) res[i] = r[i];
+	return res;
+}
+
+Poly compose(const Poly& f, const Poly& g, int n) {
+	int m = f.size();
+	if (!n) return Poly();
+	if (!m) return Poly(n);
+	// 自顶向下: 第 d 层 Q_d 的 x 长 Ns[d]，y 长 ds[d]，需要的窗口宽 Ks[d]
+	std::vector<Poly> Qs;
+	std::vector<int> Ns{n}, ds{std::min(2, m)}, Ks{1};
+	Qs.emplace_back(n * ds[0]);
+	Qs[0][0] = 1;
+	if (ds[0] == 2) rep(x, 0, std::min(n, (int)g.size()) - 1) Qs[0][x * 2 + 1] = sub(0, g[x]);
+	while (Ns.back() > 1) {
+		int N = Ns.back(), dq = ds.back(), Y = 2 * dq - 1, N2 = (N + 1) / 2, eq = std::min(Y, m);
+		const Poly& Q = Qs.back();
+		Poly V = _kron(Q, N, dq, Y) * _kron(Q, N, dq, Y, true), Q2(N2 * eq);
+		rep(x, 0, N2 - 1) rep(y, 0, eq - 1) Q2[x * eq + y] = V[2 * x * Y + y];
+		Ks.push_back(std::min(Ks.back() + dq - 1, m));
+		Ns.push_back(N2), ds.push_back(eq), Qs.push_back(std::move(Q2));
+	}
+	// 最底层: rev(f) / Q_D(0, y) 在 [m - K_D, m) 的系数
+	int D = Qs.size() - 1;
+	Poly rf(f.rbegin(), f.rend());
+	Poly t = rf * Qs[D].inverse(m);
+	Poly S(t.begin() + m - Ks[D], t.begin() + m);
+	// 自底向上: S_d[x][u] = sum Q_d(-x, y)[x1][j] S_{d+1}[x2][u + o - j] (x = x1 + 2 x2)，o = K_{d+1} - K_d
+	per(d, D - 1, 0) {
+		int N = Ns[d], dq = ds[d], K = Ks[d], K2 = Ks[d + 1], N2 = Ns[d + 1], o = K2 - K, Y = dq + K2 - 1;
+		Poly B(N * Y);
+		rep(x, 0, N2 - 1) if (2 * x < N) rep(s, 0, K2 - 1) B[2 * x * Y + s] = S[x * K2 + s];
+		Poly R = _kron(Qs[d], N, dq, Y, true) * B;
+		S.assign(N * K, 0);
+		rep(x, 0, N - 1) rep(u, 0, K - 1) S[x * K + u] = R[x * Y + u + o];
+	}
+	return S;
+}
+
+Poly compositional_inverse(const Poly& f, int n) {
+	if (n <= 1) return Poly(n);
+	int c = f[1], ic = inv(c);
+	if (n == 2) return Poly{0, ic};
+	// a_i = [x^{n-1}] f^i，R = (x / g)^{n-1}: R[n-1-i] = (n-1) / i * a_i
+	Poly w(n);
+	w[n - 1] = 1;
+	Poly F(f.begin(), f.begin() + std::min(n, (int)f.size()));
+	auto a = power_projection(w, F, n);
+	Poly R(n - 1);
+	rep(i, 1, n - 1) R[n - 1 - i] = mul(mul(n - 1, inv(i)), a[i]);
+	// x / g = c (R / c^{n-1})^{1/(n-1)}
+	R = R * inv(R[0]);
+	Poly T = R.pow(inv(n - 1), n - 1) * c;
+	Poly iT = T.inverse(n - 1), res(n);
+	rep(i, 1, n - 1) res[i] = iT[i - 1];
+	return res;
+}
+
+} // namespace poly_ext
@@ -3,35 +3,178 @@
 #include "../0-base/Poly·多项式全家桶.hpp"
 
 namespace poly_ext {
-	struct EvalImpl {
-		static void _eval_build(int node, int l, int r, const std::vector<int>& x, std::vector<Poly>& tree) {
-			if (l == r) {
-				tree[node] = Poly({sub(0, x[l]), 1});
-				return;
+	/**
+	 * 子积树 (Subproduct Tree) + 转置乘法多点求值 / 快速插值
+	 *
+	 * 结构:
+	 * 		结点 u 对应点集 x[l..r]，存 Q_u(X) = prod (1 - x_i X)，共 r - l + 2 项
+	 * 		所有结点的系数连续存放在同一块 buf 中 (off[u] 为起始位置)，自底向上逐层用 mul_batch 建树
+	 * 		同一组点建一次树，可反复用于 eval / interpolate
+	 *
+	 * 多点求值 (Tellegen 转置原理，不做多项式取模):
+	 * 		加权幂和 t_j = sum c_i x_i^j = [X^j] P_root / Q_root，P_u = P_L Q_R + P_R Q_L 的转置即为求值:
+	 * 		P_root = mulT(f, Q_root^{-1})，P_L = mulT(P_u, Q_R)，P_R = mulT(P_u, Q_L)，叶子处 P 即为 f(x_i)
+	 * 		其中 mulT(a, b)_k = sum_j a_{j+k} b_j (中间积)，一次 NTT 即可得到
+	 *
+	 * 插值:
+	 * 		c_i = y_i / M'(x_i) (M = prod (x - x_i)，M' 的点值用同一棵树求出并缓存)
+	 * 		自底向上 P_u = P_L Q_R + P_R Q_L，答案为 P_root 的反转
+	 *
+	 * 复杂度: 建树 / 求值 / 插值均为 O(n log^2 n)
+	 */
+	struct SubproductTree {
+		using Core = Poly::Core;
+		static constexpr int _NAIVE = 32;
+		int m;
+		std::vector<int> x, buf, off, w;	// w: 1 / M'(x_i)，首次插值时计算
+
+		SubproductTree(const std::vector<int>& xs) : m(xs.size()), x(xs) {
+			if (!m) return;
+			off.assign(4 * m, 0);
+			std::vector<std::vector<std::array<int, 3>>> lv;
+			int tot = 0;
+			auto collect = [&](auto&& self, int u, int l, int r, int d) -> void {
+				off[u] = tot, tot += r - l + 2;
+				if (l == r) return;
+				if ((int)lv.size() <= d) lv.resize(d + 1);
+				lv[d].push_back({u, l, r});
+				int mid = (l + r) >> 1;
+				self(self, u << 1, l, mid, d + 1);
+				self(self, u << 1 | 1, mid + 1, r, d + 1);
+			};
+			collect(collect, 1, 0, m - 1, 0);
+			buf.resize(tot);
+			auto leaf = [&](auto&& self, int u, int l, int r) -> void {
+				if (l == r) { buf[off[u]] = 1, buf[off[u] + 1] = Core::sub(0, x[l]); return; }
+				int mid = (l + r) >> 1;
+				self(self, u << 1, l, mid), self(self, u << 1 | 1, mid + 1, r);
+			};
+			leaf(leaf, 1, 0, m - 1);
+			per(d, (int)lv.size() - 1, 0) {
+				std::vector<Core::MulTask> ts;
+				for (auto& [u, l, r] : lv[d]) {
+					int mid = (l + r) >> 1;
+					ts.push_back({q(u << 1), mid - l + 2, q(u << 1 | 1), r - mid + 1, q(u)});
+				}
+				Core::mul_batch(ts.data(), ts.size());
 			}
-			int mid = (l + r) >> 1;
-			_eval_build(node << 1, l, mid, x, tree);
-			_eval_build(node << 1 | 1, mid + 1, r, x, tree);
-			tree[node] = tree[node << 1] * tree[node << 1 | 1];
 		}
 
-		static void _eval_solve(int node, int l, int r, const Poly& p, const std::vector<Poly>& tree, std::vector<int>& res) {
-			if (l == r) {
-				res[l] = p.empty() ? 0 : p[0];
+		int* q(int u) { return buf.data() + off[u]; }
+		const int* q(int u) const { return buf.data() + off[u]; }
+
+		// 中间积 res[k] = sum_j a[j + k] b[j] (0 <= k < lr)，要求 lr + lb - 1 <= la
+		static void _mulT(const int* a, int la, const int* b, int lb, int* res, int lr) {
+			if (std::min(lr, lb) <= _NAIVE) {
+				rep(k, 0, lr - 1) {
+					u64 s = 0;
+					for (int j = 0; j < lb; ) {
+						for (int e = std::min(lb, j + 16); j < e; ++j) s += (u64)a[j + k] * b[j];
+						s %= Core::mod;
+					}
+					res[k] = s;
+				}
 				return;
 			}
-			int mid = (l + r) >> 1;
-			_eval_solve(node << 1, l, mid, p % tree[node << 1], tree, res);
-			_eval_solve(node << 1 | 1, mid + 1, r, p % tree[node << 1 | 1], tree, res);
+			int limit = 1; while (limit < la) limit <<= 1;
+			typename Core::Arr ta(limit), tb(limit);
+			ta.copy_from(a, la), ta.fill_zero(la, limit);
+			rep(j, 0, lb - 1) tb[j] = b[lb - 1 - j];
+			tb.fill_zero(lb, limit);
+			Core::_dif(ta, limit), Core::_dif(tb, limit);
+			Core::_dot(ta, tb, limit);
+			Core::_dit(ta, limit);
+			std::copy(ta + lb - 1, ta + lb - 1 + lr, res);
+		}
+
+		// 自顶向下: p 为结点 u 的 P_u (r - l + 1 项)
+		void _down(int u, int l, int r, const int* p, std::vector<int>& res) const {
+			if (l == r) { res[l] = p[0]; return; }
+			int mid = (l + r) >> 1, s = r - l + 1, sl = mid - l + 1, sr = r - mid;
+			typename Core::Arr pl(sl), pr(sr);
+			if (s <= _NAIVE) {
+				_mulT(p, s, q(u << 1 | 1), sr + 1, pl, sl);
+				_mulT(p, s, q(u << 1), sl + 1, pr, sr);
+			} else {
+				// P_u 的正变换被左右两个中间积共用
+				int limit = 1; while (limit < s) limit <<= 1;
+				typename Core::Arr tp(limit), ta(limit), tb(limit);
+				tp.copy_from(p, s), tp.fill_zero(s, limit);
+				rep(j, 0, sr) ta[j] = q(u << 1 | 1)[sr - j];
+				rep(j, 0, sl) tb[j] = q(u << 1)[sl - j];
+				ta.fill_zero(sr + 1, limit), tb.fill_zero(sl + 1, limit);
+				Core::_dif(tp, limit), Core::_dif(ta, limit), Core::_dif(tb, limit);
+				Core::_dot(ta, tp, limit), Core::_dot(tb, tp, limit);
+				Core::_dit(ta, limit), Core::_dit(tb, limit);
+				std::copy(ta + sr, ta + sr + sl, (int*)pl);
+				std::copy(tb + sl, tb + sl + sr, (int*)pr);
+			}
+			_down(u << 1, l, mid, pl, res);
+			_down(u << 1 | 1, mid + 1, r, pr, res);
 		}
 
-		static std::vector<int> eval(const Poly& p, const std::vector<int>& x) {
-			int m = x.size();
-			if (m == 0) return {};
-			std::vector<Poly> tree(4 * m);
-			_eval_build(1, 0, m - 1, x, tree);
+		// 多点求值: 返回 f(x_0), ..., f(x_{m-1})
+		std::vector<int> eval(const Poly& f) const {
 			std::vector<int> res(m);
-			_eval_solve(1, 0, m - 1, p % tree[1], tree, res);
+			if (!m || f.empty()) return res;
+			// P_root[k] = sum_j f_{j+k} (Q_root^{-1})_j，f 补零到 n + m - 1 项
+			int n = f.size(), la = n + m - 1;
+			typename Core::Arr a(la), qi(n), iv(n), p(m);
+			a.copy_from(f.data(), n), a.fill_zero(n, la);
+			int lq = std::min(n, m + 1);
+			qi.copy_from(q(1), lq), qi.fill_zero(lq, n);
+			Core::inv_impl(qi, n, iv);
+			_mulT(a, la, iv, n, p, m);
+			_down(1, 0, m - 1, p, res);
+			return res;
+		}
+
+		// 自底向上: 写出结点 u 的 P_u (r - l + 1 项)
+		void _up(int u, int l, int r, const int* c, int* out) const {
+			if (l == r) { out[0] = c[l]; return; }
+			int mid = (l + r) >> 1, s = r - l + 1, sl = mid - l + 1, sr = r - mid;
+			typename Core::Arr pl(sl), pr(sr);
+			_up(u << 1, l, mid, c, pl);
+			_up(u << 1 | 1, mid + 1, r, c, pr);
+			if (s <= _NAIVE) {
+				typename Core::Arr t(s);
+				Core::_mul_naive(pl, sl, q(u << 1 | 1), sr + 1, out);
+				Core::_mul_naive(pr, sr, q(u << 1), sl + 1, t);
+				rep(i, 0, s - 1) out[i] = Core::add(out[i], t[i]);
+				return;
+			}
+			// 两个乘积在点值上相加，只做一次逆变换
+			int limit = 1; while (limit < s) limit <<= 1;
+			typename Core::Arr ta(limit), tb(limit), qa(limit), qb(limit);
+			ta.copy_from(pl, sl), ta.fill_zero(sl, limit);
+			tb.copy_from(pr, sr), tb.fill_zero(sr, limit);
+			qa.copy_from(q(u << 1 | 1), sr + 1), qa.fill_zero(sr + 1, limit);
+			qb.copy_from(q(u << 1), sl + 1), qb.fill_zero(sl + 1, limit);
+			Core::_dif(ta, limit), Core::_dif(tb, limit), Core::_dif(qa, limit), Core::_dif(qb, limit);
+			Core::_dot(ta, qa, limit), Core::_dot(tb, qb, limit);
+			rep(i, 0, limit - 1) ta[i] = Core::add(ta[i], tb[i]);
+			Core::_dit(ta, limit);
+			ta.copy_to(out, s);
+		}
+
+		// 插值: 返回次数小于 m 且满足 F(x_i) = y_i 的多项式，要求 x 互不相同
+		Poly interpolate(const std::vector<int>& y) {
+			if (!m) return Poly();
+			if (w.empty()) {
+				Poly M(q(1), q(1) + m + 1);
+				std::reverse(M.begin(), M.end());
+				w = eval(M.deriv());
+				// 批量求逆: 前缀积求一次逆元再回代
+				std::vector<int> pre(m + 1, 1);
+				rep(i, 0, m - 1) pre[i + 1] = Core::mul(pre[i], w[i]);
+				int iv = Core::inv(pre[m]);
+				per(i, m - 1, 0) { int t = Core::mul(iv, pre[i]); iv = Core::mul(iv, w[i]); w[i] = t; }
+			}
+			std::vector<int> c(m);
+			rep(i, 0, m - 1) c[i] = Core::mul(y[i], w[i]);
+			Poly res(m);
+			_up(1, 0, m - 1, c.data(), res.data());
+			std::reverse(res.begin(), res.end());
 			return res;
 		}
 	};
@@ -41,9 +184,10 @@ namespace poly_ext {
 	 * @param p The polynomial
 	 * @param x The points to evaluate at
 	 * @return std::vector<int> Values of p(x_i)
+	 * @note 同一组点需要多次求值 / 插值时，直接构造 SubproductTree 复用
 	 */
 	template<typename Poly>
 	std::vector<int> multipoint_eval(const Poly& p, const std::vector<int>& x) {
-		return EvalImpl::eval(p, x);
+		return SubproductTree(x).eval(p);
 	}
 }
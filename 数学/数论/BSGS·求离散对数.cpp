@@ -1,4 +1,5 @@
 #include "aizalib.h"
+#include "FastMod·快速取模.hpp"
 
 /**
  * BSGS (Baby-Step Giant-Step)
@@ -12,6 +13,7 @@
  * 		2. Space: O(sqrt(p))
  * 		3. 返回最小非负整数解，无解返回 -1
  * 		4. 用法/技巧: solve 仅适用于 gcd(a, p) = 1；一般情况直接用 ex_solve
+ * 		5. 步进的模乘用 Barrett 约减 (p < 2^63)，不做 128 位除法
  */
 struct BSGS {
 	struct Hash {
@@ -76,18 +78,19 @@ struct BSGS {
 
 		std::unordered_map<i64, int, Hash> mp;
 		mp.reserve((size_t)lim * 2 + 1);
+		Barrett64 br(p);
 		i64 cur = b;
 		rep(j, 0, lim - 1) {
 			mp[cur] = j;
-			cur = (i128)cur * a % p;
+			cur = br.mul(cur, a);
 		}
 
-		i64 step = _pow_mod(a, m, p);
+		i64 step = br.pow(a, m);
 		cur = step;
 		rep(i, 1, lim) {
 			auto it = mp.find(cur);
 			if (it != mp.end()) return (i64)i * m - it->second;
-			cur = (i128)cur * step % p;
+			cur = br.mul(cur, step);
 		}
 		return -1;
 	}
@@ -1,4 +1,5 @@
 #include "aizalib.h"
+#include "FastMod·快速取模.hpp"
 
 /**
  * ExLucas (扩展 Lucas)
@@ -11,6 +12,7 @@
  * 		2. Space: O(sum(p^k))
  * 		3. 通过递归计算 n! 中去掉 p 因子的部分，再补上 p 的次数
  * 		4. 用法/技巧: 若 mod 是质数可直接用 Lucas；ExLucas 更适合一般合数模数
+ * 		5. 模 p^k 的乘法用 Barrett 约减 (要求 p^k < 2^31)，预处理阶乘表时不做硬件除法
  */
 struct ExLucas {
 	static i64 _norm(i64 x, i64 mod) {
@@ -64,35 +66,33 @@ struct ExLucas {
 
 	struct PrimePowerBinom {
 		i64 p, pk;
-		std::vector<i64> pre;
+		Barrett32 br;
+		std::vector<u32> pre;
 
 		PrimePowerBinom(i64 p, int c) : p(p), pk(1) {
 			rep(i, 1, c) pk *= p;
+			AST(pk < (1ll << 31));
+			br = Barrett32(pk);
 			pre.assign((size_t)pk + 1, 1);
-			for (i64 i = 1; i <= pk; ++i) {
-				pre[(size_t)i] = pre[(size_t)(i - 1)];
-				if (i % p) pre[(size_t)i] = (i128)pre[(size_t)i] * i % pk;
-			}
+			// r = i mod p，逐步维护
+			for (i64 i = 1, r = 1; i <= pk; ++i, r = r + 1 == p ? 0 : r + 1)
+				pre[(size_t)i] = r ? br.mul(pre[(size_t)(i - 1)], (u32)i) : pre[(size_t)(i - 1)];
 		}
 
 		i64 _fact(i64 n) const {
 			if (!n) return 1;
-			i64 res = ExLucas::_pow_mod(pre[(size_t)pk], n / pk, pk);
-			res = (i128)res * pre[(size_t)(n % pk)] % pk;
-			return (i128)res * _fact(n / p) % pk;
+			u32 res = br.mul(br.pow(pre[(size_t)pk], n / pk), pre[(size_t)(n % pk)]);
+			return br.mul(res, _fact(n / p));
 		}
 
 		i64 C(i64 n, i64 m) const {
 			if (m < 0 || m > n) return 0;
 			i64 e = ExLucas::_count_p(n, p) - ExLucas::_count_p(m, p)
 				- ExLucas::_count_p(n - m, p);
-			i64 a = _fact(n);
-			i64 b = _fact(m);
-			i64 c = _fact(n - m);
-			i64 res = a;
-			res = (i128)res * ExLucas::_inv_mod(b, pk) % pk;
-			res = (i128)res * ExLucas::_inv_mod(c, pk) % pk;
-			res = (i128)res * ExLucas::_pow_mod(p, e, pk) % pk;
+			u32 res = _fact(n);
+			res = br.mul(res, ExLucas::_inv_mod(_fact(m), pk));
+			res = br.mul(res, ExLucas::_inv_mod(_fact(n - m), pk));
+			res = br.mul(res, br.pow(p % pk, e));
 			return res;
 		}
 	};
@@ -0,0 +1,129 @@
+#pragma once
+#include "aizalib.h"
+
+/**
+ * 运行时模数的快速取模 (Barrett / Montgomery)
+ * 算法介绍:
+ * 		模数在运行时才确定时，编译器无法把 % 换成乘法，每次取模都是一次 64 / 128 位硬件除法
+ * 		这里在设定模数时预计算倒数，之后的约减只用乘法与移位:
+ * 		Barrett32:    m < 2^31，乘积为 u64，q = (x * ceil(2^64 / m)) >> 64，误差至多 1
+ * 		Barrett64:    m < 2^63，乘积为 u128，im = floor((2^128 - 1) / m)，q 取 x * im 的高 128 位的近似，误差至多 3
+ * 		Montgomery64: m 为奇数且 m < 2^62，R = 2^64，数值以 Montgomery 形式保存
+ * 模板参数:
+ * 		DynModInt<Red, id>: [Red] 约减策略，[id] 区分同时存在的多个模数
+ * Interface:
+ * 		Barrett32 br(m);    br.reduce(x) (x 为任意 u64), br.mul(a, b), br.pow(a, e)
+ * 		Barrett64 br(m);    br.reduce(x) (x < m^2), br.mul(a, b), br.pow(a, e)
+ * 		Montgomery64 mg(m); mg.to(x), mg.from(x), mg.mul(a, b) (域内), mg.pow(a, e) (域内)
+ * 		using mint = DynModInt<Barrett32>; mint::set_mod(m);
+ * 		mint a = 5; a * b + c, a / b, a.pow(e), a.val()
+ * Note:
+ * 		1. 三种策略的公共接口为 mod() / to / from / mul，Barrett 的 to / from 为恒等，
+ * 		   DynModInt 只依赖这四个函数，可直接替换策略
+ * 		2. 偶数模数 (如 2^k) 只能用 Barrett；奇数的 64 位模数 Montgomery64 更快
+ * 		3. DynModInt 的除法用扩展欧几里得求逆，只要求除数与模数互质
+ */
+struct Barrett32 {
+	u32 m; u64 im;
+	Barrett32(u32 m = 1) : m(m), im((u64)-1 / m + 1) {}
+	u32 mod() const { return m; }
+	u32 reduce(u64 x) const {
+		if (m == 1) return 0;	// im 溢出为 0
+		u64 q = (u64)(((u128)x * im) >> 64), y = q * m;
+		return x < y ? x - y + m : x - y;
+	}
+	u32 mul(u32 a, u32 b) const { return reduce((u64)a * b); }
+	u32 pow(u32 a, u64 e) const {
+		u32 r = reduce(1);
+		for (; e; e >>= 1, a = mul(a, a)) if (e & 1) r = mul(r, a);
+		return r;
+	}
+	u32 to(u32 x) const { return x; }
+	u32 from(u32 x) const { return x; }
+};
+
+struct Barrett64 {
+	u64 m; u128 im;
+	Barrett64(u64 m = 1) : m(m), im(~(u128)0 / m) {}
+	u64 mod() const { return m; }
+	u64 reduce(u128 x) const {
+		u64 xh = x >> 64, xl = x, ih = im >> 64, il = im;
+		u128 a = (u128)xh * il, b = (u128)xl * ih, t = ((u128)xl * il) >> 64;
+		u128 mid = (u128)(u64)a + (u64)b + t;
+		u128 q = (u128)xh * ih + (a >> 64) + (b >> 64) + (mid >> 64);
+		u128 r = x - q * m;
+		while (r >= m) r -= m;
+		return r;
+	}
+	u64 mul(u64 a, u64 b) const { return reduce((u128)a * b); }
+	u64 pow(u64 a, u64 e) const {
+		u64 r = reduce(1);
+		for (; e; e >>= 1, a = mul(a, a)) if (e & 1) r = mul(r, a);
+		return r;
+	}
+	u64 to(u64 x) const { return x; }
+	u64 from(u64 x) const { return x; }
+};
+
+struct Montgomery64 {
+	u64 m, ni, r2;	// ni = -m^{-1} mod 2^64，r2 = 2^128 mod m
+	Montgomery64(u64 m = 1) : m(m) {
+		u64 x = m;
+		rep(i, 1, 5) x *= 2 - m * x;
+		ni = -x, r2 = (-(u128)m) % m;
+	}
+	u64 mod() const { return m; }
+	u64 _red(u128 t) const {
+		u64 r = (t + (u128)((u64)t * ni) * m) >> 64;
+		return r >= m ? r - m : r;
+	}
+	u64 to(u64 x) const { return _red((u128)x * r2); }
+	u64 from(u64 x) const { return _red(x); }
+	u64 mul(u64 a, u64 b) const { return _red((u128)a * b); }
+	u64 pow(u64 a, u64 e) const {
+		u64 r = to(1);
+		for (; e; e >>= 1, a = mul(a, a)) if (e & 1) r = mul(r, a);
+		return r;
+	}
+};
+
+template<typename Red = Barrett32, int id = 0>
+struct DynModInt {
+	using T = decltype(Red().mod());
+	inline static Red red{1};
+	T v;	// 策略域内的值 (Montgomery 形式或原值)
+
+	static void set_mod(u64 m) { red = Red((T)m); }
+	static T mod() { return red.mod(); }
+	static DynModInt raw(T x) { DynModInt r; r.v = x; return r; }
+
+	DynModInt() : v(0) {}
+	DynModInt(i64 x) {
+		i64 m = (i64)mod();
+		x %= m;
+		v = red.to(x < 0 ? x + m : x);
+	}
+	T val() const { return red.from(v); }
+
+	DynModInt& operator+=(const DynModInt& b) { v += b.v; if (v >= mod()) v -= mod(); return *this; }
+	DynModInt& operator-=(const DynModInt& b) { v = v >= b.v ? v - b.v : v + mod() - b.v; return *this; }
+	DynModInt& operator*=(const DynModInt& b) { v = red.mul(v, b.v); return *this; }
+	DynModInt& operator/=(const DynModInt& b) { return *this *= b.inv(); }
+	friend DynModInt operator+(DynModInt a, const DynModInt& b) { return a += b; }
+	friend DynModInt operator-(DynModInt a, const DynModInt& b) { return a -= b; }
+	friend DynModInt operator*(DynModInt a, const DynModInt& b) { return a *= b; }
+	friend DynModInt operator/(DynModInt a, const DynModInt& b) { return a /= b; }
+	DynModInt operator-() const { return raw(v ? mod() - v : 0); }
+	bool operator==(const DynModInt& b) const { return v == b.v; }
+	bool operator!=(const DynModInt& b) const { return v != b.v; }
+
+	DynModInt pow(u64 e) const { return raw(red.pow(v, e)); }
+	// 扩展欧几里得求逆，要求 gcd(val, mod) = 1
+	DynModInt inv() const {
+		i64 a = val(), b = mod(), x = 1, y = 0;
+		while (b) { i64 q = a / b; a -= q * b, std::swap(a, b); x -= q * y, std::swap(x, y); }
+		AST(a == 1);
+		return DynModInt(x);
+	}
+	friend std::ostream& operator<<(std::ostream& os, const DynModInt& a) { return os << a.val(); }
+};
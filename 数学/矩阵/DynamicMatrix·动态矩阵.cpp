@@ -16,6 +16,8 @@
  * 		1. 乘法采用 i-k-j 循环序
  * 		2. det()/inverse() 对浮点类型使用主元消元，非浮点类型使用非零判断
  * 		3. det()/inverse() 需 T 支持除法和 std::abs (浮点) / != T(0) (非浮点)
+ * 		4. 运行时模数: T = DynModInt<Barrett32> (FastMod·快速取模.hpp)，乘法与消元的内层循环只有 Barrett 乘加，不做硬件除法；
+ * 		   det()/inverse() 每个主元求一次逆元 (扩展欧几里得，O(log m) 次除法)，共 O(n log m) 次硬件除法
  */
 template<typename T>
 struct Matrix {
@@ -120,13 +122,15 @@ struct Matrix {
 			rep(j, i + 1, n - 1) {
 				if constexpr (std::is_floating_point_v<T>) {
 					if (std::abs(tmp[j][i]) > std::abs(tmp[pivot][i])) pivot = j;
+				} else {
+					if (tmp[j][i] != T(0) && tmp[pivot][i] == T(0)) pivot = j;
 				}
 			}
 			if (tmp[pivot][i] == T(0)) return Matrix(0, 0);  // singular
 			if (pivot != i)
 				rep(k, 0, 2 * n - 1) std::swap(tmp[i][k], tmp[pivot][k]);
-			T div = tmp[i][i];
-			rep(k, 0, 2 * n - 1) tmp[i][k] /= div;
+			T inv = T(1) / tmp[i][i];
+			rep(k, 0, 2 * n - 1) tmp[i][k] *= inv;
 			rep(j, 0, n - 1) {
 				if (j == i) continue;
 				T f = tmp[j][i];
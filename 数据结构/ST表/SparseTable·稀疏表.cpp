@@ -22,6 +22,7 @@
  * 		4. 用法/技巧:
  * 			4.1 要求 merge 满足幂等性，如 min / max / gcd；普通求和不适用 O(1) 双块查询。
  * 			4.2 merge 建议传无状态 lambda / functor，避免 std::function 常数。
+ * 			4.3 层号用 bit_width 现算而不查 log 表: 查表是查询中第三次随机访存，n 大时同样会缺失。
  */
 template<typename Merge, typename T>
 concept STMerge = requires(Merge merge, const T& x, const T& y) {
@@ -32,7 +33,6 @@ template<typename T, typename Merge>
 requires STMerge<Merge, T>
 struct SparseTable {
 	int n = 0, lg = 0;
-	std::vector<int> lo;
 	std::vector<std::vector<T>> st;
 	Merge merge;
 
@@ -43,14 +43,11 @@ struct SparseTable {
 		n = (int)a.size() - 1;
 		if (n <= 0) {
 			lg = 0;
-			lo.assign(1, 0);
 			st.clear();
 			return;
 		}
 
 		lg = std::bit_width((unsigned int)n) - 1;
-		lo.assign(n + 1, 0);
-		rep(i, 2, n) lo[i] = lo[i >> 1] + 1;
 
 		st.assign(lg + 1, std::vector<T>(n + 1));
 		rep(i, 1, n) st[0][i] = a[i];
@@ -65,7 +62,7 @@ struct SparseTable {
 
 	T query(int l, int r) const {
 		AST(1 <= l && l <= r && r <= n);
-		int k = lo[r - l + 1];
+		int k = std::bit_width((unsigned int)(r - l + 1)) - 1;
 		return merge(st[k][l], st[k][r - (1 << k) + 1]);
 	}
 };
@@ -10,20 +10,33 @@
  * 		DynSegTree(int n, int reserve_nodes = 0): 初始化定义域 [1, n] 的空线段树
  * 		DynSegTree(int l, int r, int reserve_nodes): 初始化定义域 [l, r] 的空线段树
  * 		void reserve(int reserve_nodes): 预留结点池空间
+ * 		void compact(): 按先序重排存活结点，清空空闲链表并释放多余容量
+ * 		MemoryUsage memory_usage(): 存活 / 空闲结点数、容量与占用字节数
  * 		void modify(int ql, int qr, const Tag& tag): 区间打标记
  * 		Info query(int ql, int qr): 查询区间信息
  * 		Info all_info(): 返回整棵树信息
  * 		void set(int pos, const Info& value): 单点赋值
  * 		int find_first(int ql, int qr, Pred pred): 在线段树上二分第一个满足条件的位置
  * 		int find_last(int ql, int qr, Pred pred): 在线段树上二分最后一个满足条件的位置
+ * 		int max_right(int ql, Pred pred): 最大的 r 使 pred(query(ql, r)) 为真 (不存在时为 ql - 1)
+ * 		int min_left(int qr, Pred pred): 最小的 l 使 pred(query(l, qr)) 为真 (不存在时为 qr + 1)
  * Note:
  * 		1. Time: 单次 modify / query / set / find O(log V)，V = r - l + 1
- * 		2. Space: O(实际访问结点数)
+ * 		2. Space: O(存活结点数)；开启回收时已回到初始状态的子树会被折叠掉，见 Note 8
  * 		3. `Info` 需要支持 `operator+` 和 `static Info from_range(int l, int r)`
  * 		4. `Tag` 需要支持 `merge(rhs)`、`has_value()`、`apply_to(Info&, int l, int r)`
  * 		5. 空结点默认表示其整段区间都处于初始状态，因此 `Info::from_range(l, r)` 必须返回该区间的默认信息
  * 		6. `find_first / find_last` 中的 `pred(info)` 应满足单调性，否则二分结果没有意义
- * 		7. 当前二分不维护前缀累加器；适合用 `max/min/exists` 等区间信息判定，前缀和二分需另写带 accumulator 的版本
+ * 		7. `find_first / find_last` 不维护前缀累加器，适合用 `max/min/exists` 等区间信息判定；
+ * 		   前缀和一类的二分用 `max_right / min_left`，pred 作用在从端点开始累加的 Info 上，要求随区间伸长由真变假，一次下降 O(log V)
+ * 		8. 结点回收: Info 支持 `==` 且 gc 为真 (默认) 时，modify / set 对整段覆盖的结点和路径旁的兄弟结点做折叠:
+ * 		   信息等于 from_range 的结点先把标记推给儿子，再递归折叠儿子，最后没有儿子、没有标记的结点收回空闲链表，
+ * 		   因此被祖先上的反向标记抵消掉的整棵子树 (如区间加后再减回去) 也会被折叠；新建结点优先复用空闲链表。
+ * 		   路径上的结点在回溯时同样检查。只被 query 等下推改动过、之后再没有修改经过的结点不会被回收
+ * 		   要求 / 复杂度: 折叠只在 info == from_range 时向下走；若这蕴含"整段都处于初始状态" (如非负计数、同时维护 min 与 max)，
+ * 		   走到的结点都会被回收，折叠的代价均摊到建点上。否则 (如有正有负的区间和恰为 0) 结果仍正确，
+ * 		   但这类子树可能被反复遍历，应设 gc = false
+ * 		9. 空闲结点只在 compact() 时真正还给系统；compact 还会按先序重新编号，同一条路径上的结点相邻，遍历更友好
  */
 
 template<class Info>
@@ -48,9 +61,16 @@ struct DynSegTree {
 		Tag tag = Tag();
 	};
 
+	struct MemoryUsage {
+		int live, free, capacity; // 存活结点、空闲链表中的结点、结点池容量 (都不含 0 号空结点)
+		u64 bytes;                // 结点池与空闲链表实际占用的字节数
+	};
+
 	int lb = 0, rb = -1;
 	int root = 0;
 	std::vector<Node> tr;
+	std::vector<int> fre; // 空闲结点编号
+	bool gc = true;       // 是否回收回到初始状态的结点 (要求 Info 支持 ==)
 
 	DynSegTree() { tr.push_back({}); }
 
@@ -63,20 +83,34 @@ struct DynSegTree {
 		lb = l;
 		rb = r;
 		root = 0;
-		tr.clear();
+		tr.clear(), fre.clear();
 		tr.reserve(std::max(2, reserve_nodes + 1));
 		tr.push_back({});
 	}
 
 	void reserve(int reserve_nodes) { if (reserve_nodes + 1 > (int)tr.capacity()) tr.reserve(reserve_nodes + 1); }
 
-	void modify(int ql, int qr, const Tag& v) { AST(lb <= ql && ql <= qr && qr <= rb); _modify(root, ql, qr, v, lb, rb); }
+	void compact() {
+		std::vector<Node> nt;
+		nt.reserve(tr.size() - fre.size());
+		nt.push_back({});
+		root = _compact(root, nt);
+		tr.swap(nt);
+		fre.clear(), fre.shrink_to_fit();
+	}
+
+	MemoryUsage memory_usage() const {
+		int fc = fre.size();
+		return {(int)tr.size() - 1 - fc, fc, (int)tr.capacity() - 1, tr.capacity() * sizeof(Node) + fre.capacity() * sizeof(int)};
+	}
+
+	void modify(int ql, int qr, const Tag& v) { AST(lb <= ql && ql <= qr && qr <= rb); root = _modify(root, ql, qr, v, lb, rb); }
 
 	Info query(int ql, int qr) { AST(lb <= ql && ql <= qr && qr <= rb); return _query(root, ql, qr, lb, rb); }
 
 	Info all_info() const { AST(lb <= rb); return _get_info(root, lb, rb); }
 
-	void set(int pos, const Info& v) { AST(lb <= pos && pos <= rb); _set(root, pos, v, lb, rb); }
+	void set(int pos, const Info& v) { AST(lb <= pos && pos <= rb); root = _set(root, pos, v, lb, rb); }
 
 	template<class Pred>
 	int find_first(int ql, int qr, Pred pred) { AST(lb <= ql && ql <= qr && qr <= rb); return _find_first(root, ql, qr, pred, lb, rb); }
@@ -84,7 +118,77 @@ struct DynSegTree {
 	template<class Pred>
 	int find_last(int ql, int qr, Pred pred) { AST(lb <= ql && ql <= qr && qr <= rb); return _find_last(root, ql, qr, pred, lb, rb); }
 
-	int _new_node(int l, int r) { tr.push_back({0, 0, Info::from_range(l, r), Tag()}); return (int)tr.size() - 1; }
+	template<class Pred>
+	int max_right(int ql, Pred pred) {
+		AST(lb <= ql && ql <= rb + 1);
+		if (ql > rb) return rb;
+		Info acc;
+		bool has = false;
+		int res = rb;
+		_max_right(root, ql, pred, acc, has, res, lb, rb);
+		return res;
+	}
+
+	template<class Pred>
+	int min_left(int qr, Pred pred) {
+		AST(lb - 1 <= qr && qr <= rb);
+		if (qr < lb) return lb;
+		Info acc;
+		bool has = false;
+		int res = lb;
+		_min_left(root, qr, pred, acc, has, res, lb, rb);
+		return res;
+	}
+
+	// 结点编号在调用期间可能因扩容失效，因此内部函数都按值传编号、返回新编号，不持有 tr 中元素的引用
+	int _new_node(int l, int r) {
+		if (!fre.empty()) {
+			int p = fre.back();
+			fre.pop_back();
+			tr[p] = {0, 0, Info::from_range(l, r), Tag()};
+			return p;
+		}
+		tr.push_back({0, 0, Info::from_range(l, r), Tag()});
+		return (int)tr.size() - 1;
+	}
+
+	// p 没有儿子、没有标记且信息为初始值时回收并返回 0 (叶子上的标记不会再下推，判定时忽略)
+	int _collect(int p, int l, int r) {
+		if constexpr (std::equality_comparable<Info>) {
+			if (gc && !tr[p].ls && !tr[p].rs && (l == r || !tr[p].tag.has_value()) && tr[p].info == Info::from_range(l, r)) {
+				fre.push_back(p);
+				return 0;
+			}
+		}
+		return p;
+	}
+
+	// p 的信息为初始值时把标记推给儿子并递归折叠，整棵子树都回到初始状态时返回 0
+	int _fold(int p, int l, int r) {
+		if (!p) return 0;
+		if constexpr (std::equality_comparable<Info>) {
+			if (!gc || !(tr[p].info == Info::from_range(l, r))) return p;
+			if (l < r) {
+				if (tr[p].tag.has_value()) {
+					if (!tr[p].ls || !tr[p].rs) return p; // 缺的一侧下推后就不再是初始状态
+					_push(p, l, r);
+				}
+				int mid = (l + r) >> 1;
+				tr[p].ls = _fold(tr[p].ls, l, mid);
+				tr[p].rs = _fold(tr[p].rs, mid + 1, r);
+			}
+		}
+		return _collect(p, l, r);
+	}
+
+	int _compact(int p, std::vector<Node>& nt) {
+		if (!p) return 0;
+		int q = nt.size();
+		nt.push_back(tr[p]);
+		nt[q].ls = _compact(tr[p].ls, nt);
+		nt[q].rs = _compact(tr[p].rs, nt);
+		return q;
+	}
 
 	Info _get_info(int p, int l, int r) const { return p ? tr[p].info : Info::from_range(l, r); }
 
@@ -94,44 +198,45 @@ struct DynSegTree {
 		tr[p].info = _get_info(tr[p].ls, l, mid) + _get_info(tr[p].rs, mid + 1, r);
 	}
 
-	void _apply(int& p, const Tag& v, int l, int r) {
+	int _apply(int p, const Tag& v, int l, int r) {
 		if (!p) p = _new_node(l, r);
 		v.apply_to(tr[p].info, l, r), tr[p].tag.merge(v);
+		return p;
 	}
 
 	void _push(int p, int l, int r) {
 		if (l == r || !tr[p].tag.has_value()) return;
 		int mid = (l + r) >> 1;
-		_apply(tr[p].ls, tr[p].tag, l, mid);
-		_apply(tr[p].rs, tr[p].tag, mid + 1, r);
+		Tag v = tr[p].tag;
 		tr[p].tag = Tag();
+		tr[p].ls = _apply(tr[p].ls, v, l, mid);
+		tr[p].rs = _apply(tr[p].rs, v, mid + 1, r);
 	}
 
-	void _modify(int& p, int ql, int qr, const Tag& v, int l, int r) {
-		if (ql <= l && r <= qr) {
-			_apply(p, v, l, r);
-			return;
-		}
+	int _modify(int p, int ql, int qr, const Tag& v, int l, int r) {
+		if (ql <= l && r <= qr) return _fold(_apply(p, v, l, r), l, r);
 		if (!p) p = _new_node(l, r);
 		_push(p, l, r);
 		int mid = (l + r) >> 1;
-		if (ql <= mid) _modify(tr[p].ls, ql, qr, v, l, mid);
-		if (qr > mid) _modify(tr[p].rs, ql, qr, v, mid + 1, r);
+		tr[p].ls = ql <= mid ? _modify(tr[p].ls, ql, qr, v, l, mid) : _fold(tr[p].ls, l, mid);
+		tr[p].rs = qr > mid ? _modify(tr[p].rs, ql, qr, v, mid + 1, r) : _fold(tr[p].rs, mid + 1, r);
 		_pull(p, l, r);
+		return _collect(p, l, r);
 	}
 
-	void _set(int& p, int pos, const Info& v, int l, int r) {
+	int _set(int p, int pos, const Info& v, int l, int r) {
 		if (!p) p = _new_node(l, r);
 		if (l == r) {
 			tr[p].info = v;
 			tr[p].tag = Tag();
-			return;
+			return _collect(p, l, r);
 		}
 		_push(p, l, r);
 		int mid = (l + r) >> 1;
-		if (pos <= mid) _set(tr[p].ls, pos, v, l, mid);
-		else _set(tr[p].rs, pos, v, mid + 1, r);
+		tr[p].ls = pos <= mid ? _set(tr[p].ls, pos, v, l, mid) : _fold(tr[p].ls, l, mid);
+		tr[p].rs = pos > mid ? _set(tr[p].rs, pos, v, mid + 1, r) : _fold(tr[p].rs, mid + 1, r);
 		_pull(p, l, r);
+		return _collect(p, l, r);
 	}
 
 	Info _query(int p, int ql, int qr, int l, int r) {
@@ -157,6 +262,42 @@ struct DynSegTree {
 		return -1;
 	}
 
+	// acc 为 [ql, l - 1] 的累加值；答案落在 [l, r] 内时写入 res 并返回 true
+	template<class Pred>
+	bool _max_right(int p, int ql, Pred& pred, Info& acc, bool& has, int& res, int l, int r) {
+		if (r < ql) return false;
+		if (ql <= l) {
+			Info x = _get_info(p, l, r), t = has ? acc + x : x;
+			if (pred(t)) {
+				acc = t, has = true;
+				return false;
+			}
+			if (l == r) return res = l - 1, true;
+		}
+		if (p) _push(p, l, r);
+		int mid = (l + r) >> 1;
+		return _max_right(p ? tr[p].ls : 0, ql, pred, acc, has, res, l, mid)
+			|| _max_right(p ? tr[p].rs : 0, ql, pred, acc, has, res, mid + 1, r);
+	}
+
+	// acc 为 [r + 1, qr] 的累加值
+	template<class Pred>
+	bool _min_left(int p, int qr, Pred& pred, Info& acc, bool& has, int& res, int l, int r) {
+		if (l > qr) return false;
+		if (r <= qr) {
+			Info x = _get_info(p, l, r), t = has ? x + acc : x;
+			if (pred(t)) {
+				acc = t, has = true;
+				return false;
+			}
+			if (l == r) return res = r + 1, true;
+		}
+		if (p) _push(p, l, r);
+		int mid = (l + r) >> 1;
+		return _min_left(p ? tr[p].rs : 0, qr, pred, acc, has, res, mid + 1, r)
+			|| _min_left(p ? tr[p].ls : 0, qr, pred, acc, has, res, l, mid);
+	}
+
 	template<class Pred>
 	int _find_last(int p, int ql, int qr, Pred pred, int l, int r) {
 		if (ql <= l && r <= qr && !pred(_get_info(p, l, r))) return -1;
@@ -0,0 +1,102 @@
+#include "aizalib.h"
+#include "SegTreeIter·非递归线段树.hpp"
+#include "../../树状数组/FenwickTree·树状数组.cpp"
+#include "../../ST表/SparseTable·稀疏表.cpp"
+
+/**
+ * 单点修改 / 区间查询结构的布局基准 (micro-benchmark)
+ * 用法:
+ * 		g++ -O2 -march=native 编译，./a.out [n1 n2 ...]，默认 n = 1e6 1e7；n = 1e8 约需 3GB 内存
+ * 测定内容:
+ * 		每个 n 预先生成 Q 个随机单点修改和 Q 个随机区间查询，分别计时，输出每次操作的纳秒数
+ * 		1. SegTreePoint (递归，4n 结点) / SegTreeIterPoint (非递归，堆序即 Eytzinger 序，2 size 结点)
+ * 		2. BitTree / PadBit<10>: 后者为本文件内的对照实现，每 2^10 个位置插一个空位 (下标 i 存在 i + (i >> 10))
+ * 		3. SparseTable: 只测查询 (n <= 1e7，空间 O(n log n))
+ * Note:
+ * 		1. Info 为 8 字节的区间和；n > 5e7 时跳过递归版，n > 1e7 时跳过 SparseTable
+ * 		2. 一组结果 (单核 Xeon，L2 2MB，L3 105MB；ns / op，修改 | 查询):
+ * 			n            1e6         1e7         1e8
+ * 			SegTreePoint 333 | 492   474 | 907   -
+ * 			SegTreeIter  264 | 274   406 | 435   858 | 852
+ * 			BitTree      80 | 103    150 | 216   293 | 451
+ * 			PadBit<10>   103 | 119   116 | 172   341 | 445
+ * 			SparseTable  - | 27      - | 45      -          (改用 bit_width 前为 48 / 91)
+ * 		3. 结论: 堆序的自底向上线段树中，同一次操作访问的各层地址只由下标决定、互不依赖，乱序执行已经让这些缺失并行，
+ * 		   软件预取只增加指令；按 B 层分块 (vEB 式) 的布局还要多算地址，兄弟结点跨块，在这台机器上比堆序慢 1.5 ~ 2 倍，因此没有保留。
+ * 		   树状数组插空位只在 n = 1e7 时更快 (修改 -23%，查询 -20%)；n = 1e6 时修改 / 查询慢 29% / 16%，
+ * 		   n = 1e8 时修改慢 16%、查询持平。收益不稳定且依赖缓存结构，因此只作为对照保留在本文件中，BitTree 不提供该选项
+ */
+struct Sum {
+	i64 v = 0;
+	friend Sum operator+(const Sum& a, const Sum& b) { return {a.v + b.v}; }
+};
+
+const int Q = 2000000;
+std::vector<int> pos, ql, qr;
+std::vector<i64> val;
+
+template<typename F>
+double bench(F&& f) {
+	auto st = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - st).count() / Q;
+}
+
+i64 sink = 0;
+
+// 每 2^H 个位置插一个空位的树状数组，只用于与 BitTree 对照
+template<int H>
+struct PadBit {
+	int n;
+	std::vector<i64> tr;
+	PadBit(int n) : n(n), tr(n + (n >> H) + 1) {}
+	static int _id(int i) { return i + (i >> H); }
+	void add(int p, i64 v) { for (; p <= n; p += p & -p) tr[_id(p)] += v; }
+	i64 pre(int p) const { i64 r = 0; for (; p; p -= p & -p) r += tr[_id(p)]; return r; }
+	i64 sum(int l, int r) const { return pre(r) - pre(l - 1); }
+};
+
+// 只在 set / query 上计时，建树不计
+template<typename Tree>
+void run_seg(const char* name, int n) {
+	Tree t(n);
+	double ts = bench([&] { rep(i, 0, Q - 1) t.set(pos[i], {val[i]}); });
+	double tq = bench([&] { rep(i, 0, Q - 1) sink += t.query(ql[i], qr[i]).v; });
+	printf("  %-24s set %7.1f  query %7.1f\n", name, ts, tq);
+}
+
+template<typename Bit>
+void run_bit(const char* name, int n) {
+	Bit t(n);
+	double ts = bench([&] { rep(i, 0, Q - 1) t.add(pos[i], val[i]); });
+	double tq = bench([&] { rep(i, 0, Q - 1) sink += t.sum(ql[i], qr[i]); });
+	printf("  %-24s add %7.1f  query %7.1f\n", name, ts, tq);
+}
+
+int main(int argc, char** argv) {
+	std::vector<int> ns;
+	rep(i, 1, argc - 1) ns.push_back(atoi(argv[i]));
+	if (ns.empty()) ns = {1000000, 10000000};
+	std::mt19937 rng(20240601);
+	for (int n : ns) {
+		pos.resize(Q), ql.resize(Q), qr.resize(Q), val.resize(Q);
+		rep(i, 0, Q - 1) {
+			pos[i] = rng() % n + 1, val[i] = rng() % 1000;
+			ql[i] = rng() % n + 1, qr[i] = rng() % n + 1;
+			if (ql[i] > qr[i]) std::swap(ql[i], qr[i]);
+		}
+		printf("n = %d\n", n);
+		if (n <= 50000000) run_seg<SegTreePoint<Sum>>("SegTreePoint", n);
+		run_seg<SegTreeIterPoint<Sum>>("SegTreeIterPoint", n);
+		run_bit<BitTree<i64>>("BitTree", n);
+		run_bit<PadBit<10>>("PadBit<10>", n);
+		if (n <= 10000000) {
+			std::vector<i64> a(n + 1);
+			rep(i, 1, n) a[i] = rng();
+			SparseTable st(a, [](i64 x, i64 y) { return std::min(x, y); });
+			double tq = bench([&] { rep(i, 0, Q - 1) sink += st.query(ql[i], qr[i]); });
+			printf("  %-24s             query %7.1f\n", "SparseTable (min)", tq);
+		}
+	}
+	printf("(%lld)\n", sink & 1);
+}
@@ -15,6 +15,9 @@
  * 		void set(int pos, const Info& value): 单点赋值
  * 		int find_first(int ql, int qr, Pred pred): 在线段树上二分第一个满足条件的位置
  * 		int find_last(int ql, int qr, Pred pred): 在线段树上二分最后一个满足条件的位置
+ * 		int max_right(int ql, Pred pred): 最大的 r 使 pred(query(ql, r)) 为真 (不存在时为 ql - 1)
+ * 		int min_left(int qr, Pred pred): 最小的 l 使 pred(query(l, qr)) 为真 (不存在时为 qr + 1)
+ * 		std::vector<Info> batch(std::span<const Op> ops): 批量执行修改 / 查询，按输入顺序返回各查询的答案
  * Note:
  * 		1. Time: build O(n)，modify / query / set / find O(log n)
  * 		2. Space: O(n)
@@ -23,8 +26,13 @@
  * 			4.1 `Info` 需要支持 `operator+`，用于合并左右儿子信息。
  * 			4.2 `Tag` 需要支持 `merge(rhs)`、`has_value()`、`apply_to(Info&, int l, int r)`。
  * 			4.3 `find_first / find_last` 中的 `pred(info)` 应满足单调性，否则二分结果没有意义。
- * 			4.4 当前二分不维护前缀累加器；适合用 `max/min/exists` 等区间信息判定，前缀和二分需另写带 accumulator 的版本。
+ * 			4.4 `find_first / find_last` 不维护前缀累加器，适合用 `max/min/exists` 等区间信息判定；
+ * 			    前缀和一类的二分用 `max_right / min_left`，pred 作用在从端点开始累加的 Info 上，要求随区间伸长由真变假，
+ * 			    如第 k 个 1: `max_right(1, [&](const Info& x) { return x.sum < k; }) + 1`，一次下降 O(log n)。
  * 			4.5 不需要懒标记时可直接用 `SegNullTag<Info>`，或 `SegTreePoint<Info>` 别名。
+ * 			4.6 `batch` 的结果与逐个调用 modify / query 完全相同: 修改按原顺序执行；两次修改之间的一段查询互不影响，
+ * 			    树较大且这段查询够长时按左端点基数排序后再执行，相邻查询的左边界路径基本重合，路径上的结点还在缓存里。
+ * 			4.7 对常数敏感 (递归开销、4n 空间) 时可换用 SegTreeIter·非递归线段树.hpp，接口与 Info / Tag 要求相同。
  */
 
 template<class Info>
@@ -100,6 +108,68 @@ struct SegTree {
 		return _find_last(ql, qr, pred, 1, 1, n);
 	}
 
+	template<class Pred>
+	int max_right(int ql, Pred pred) {
+		AST(1 <= ql && ql <= n + 1);
+		if (ql > n) return n;
+		Info acc;
+		bool has = false;
+		int res = _max_right(ql, pred, acc, has, 1, 1, n);
+		return res == -1 ? n : res;
+	}
+
+	template<class Pred>
+	int min_left(int qr, Pred pred) {
+		AST(0 <= qr && qr <= n);
+		if (qr < 1) return 1;
+		Info acc;
+		bool has = false;
+		int res = _min_left(qr, pred, acc, has, 1, 1, n);
+		return res == -1 ? 1 : res;
+	}
+
+	// 批量操作: is_query 为真时是查询 [l, r]，否则是对 [l, r] 打 tag
+	struct Op {
+		int l, r;
+		Tag tag = Tag();
+		bool is_query = false;
+	};
+	// 连续查询不少于 batch_sort_min 个且 n >= batch_sort_n (树放不进 L2) 时才排序，否则排序与回填的开销大于省下的缓存缺失
+	static constexpr int batch_sort_min = 64, batch_sort_n = 1 << 17;
+
+	std::vector<Info> batch(std::span<const Op> ops) {
+		std::vector<Info> res;
+		struct Item { int l, r, id; };
+		std::vector<Item> key, tmp;
+		for (int i = 0, m = ops.size(); i < m;) {
+			if (!ops[i].is_query) {
+				modify(ops[i].l, ops[i].r, ops[i].tag);
+				++i;
+				continue;
+			}
+			int j = i, base = res.size();
+			while (j < m && ops[j].is_query) ++j;
+			res.resize(base + j - i);
+			if (j - i < batch_sort_min || n < batch_sort_n) {
+				rep(k, i, j - 1) res[base + k - i] = query(ops[k].l, ops[k].r);
+			} else {
+				// 按左端点做稳定的 LSD 基数排序 (每轮 11 位)，端点随下标一起搬运，执行时顺序读
+				key.resize(j - i), tmp.resize(j - i);
+				rep(k, i, j - 1) key[k - i] = {ops[k].l, ops[k].r, base + k - i};
+				for (int sh = 0; (n >> sh) > 0; sh += 11) {
+					int cnt[1 << 11 | 1] = {};
+					for (auto& x : key) ++cnt[(x.l >> sh & 2047) + 1];
+					rep(d, 1, 2047) cnt[d] += cnt[d - 1];
+					for (auto& x : key) tmp[cnt[x.l >> sh & 2047]++] = x;
+					key.swap(tmp);
+				}
+				for (auto& x : key) res[x.id] = query(x.l, x.r);
+			}
+			i = j;
+		}
+		return res;
+	}
+
 	void _build(const std::vector<Info>& init, int p, int l, int r) {
 		if (l == r) {
 			info[p] = init[l];
@@ -190,6 +260,42 @@ struct SegTree {
 		return -1;
 	}
 
+	// acc 为 [ql, l - 1] 的累加值；返回 -1 表示整段都可并入 acc，否则返回答案
+	template<class Pred>
+	int _max_right(int ql, Pred& pred, Info& acc, bool& has, int p, int l, int r) {
+		if (r < ql) return -1;
+		if (ql <= l) {
+			Info t = has ? acc + info[p] : info[p];
+			if (pred(t)) {
+				acc = t, has = true;
+				return -1;
+			}
+			if (l == r) return l - 1;
+		}
+		_push(p, l, r);
+		int mid = (l + r) >> 1;
+		int res = _max_right(ql, pred, acc, has, LS);
+		return res != -1 ? res : _max_right(ql, pred, acc, has, RS);
+	}
+
+	// acc 为 [r + 1, qr] 的累加值
+	template<class Pred>
+	int _min_left(int qr, Pred& pred, Info& acc, bool& has, int p, int l, int r) {
+		if (l > qr) return -1;
+		if (r <= qr) {
+			Info t = has ? info[p] + acc : info[p];
+			if (pred(t)) {
+				acc = t, has = true;
+				return -1;
+			}
+			if (l == r) return r + 1;
+		}
+		_push(p, l, r);
+		int mid = (l + r) >> 1;
+		int res = _min_left(qr, pred, acc, has, RS);
+		return res != -1 ? res : _min_left(qr, pred, acc, has, LS);
+	}
+
 #undef LS
 #undef RS
 };
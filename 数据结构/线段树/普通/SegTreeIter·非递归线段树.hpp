@@ -0,0 +1,227 @@
+#pragma once
+
+#include "SegTreeBase·通用线段树基类.hpp"
+
+/**
+ * 非递归懒标记线段树 (Bottom-up Lazy Segment Tree)
+ * 算法介绍: 与 SegTree 接口和 Info / Tag 约定相同的自底向上实现。叶子数补到 2 的幂 size，结点 p 的儿子为 2p / 2p+1，叶子 i 存在 size + i - 1。
+ * 		区间操作先自顶向下下推两端点的祖先，再在叶子层上从两侧向中间收缩得到 O(log n) 个整段结点，最后自底向上更新两端点的祖先。
+ * 模板参数: Info (节点信息), Tag (懒标记)
+ * Interface:
+ * 		SegTreeIter(int n): 初始化长度为 n 的空线段树
+ * 		SegTreeIter(const std::vector<Info>& init): 用 1-based 的 Info 数组建树
+ * 		void modify(int ql, int qr, const Tag& tag): 区间打标记
+ * 		Info query(int ql, int qr): 查询区间信息
+ * 		Info all_info(): 返回整棵树信息
+ * 		void set(int pos, const Info& value): 单点赋值
+ * 		int find_first(int ql, int qr, Pred pred): 在线段树上二分第一个满足条件的位置
+ * 		int find_last(int ql, int qr, Pred pred): 在线段树上二分最后一个满足条件的位置
+ * 		int max_right(int ql, Pred pred) / int min_left(int qr, Pred pred): 带前缀累加器的二分，语义同 SegTree
+ * Note:
+ * 		1. Time: build O(n)，modify / query / set / find O(log n)，无递归
+ * 		2. Space: info 2 size 个，tag 只存在内部结点上，size 个 (size < 2n)
+ * 		3. 1-based indexing.
+ * 		4. 用法/技巧:
+ * 			4.1 `Info` / `Tag` 的要求与 SegTree 完全相同，可直接把 `SegTree<Info, Tag>` 替换为 `SegTreeIter<Info, Tag>`。
+ * 			4.2 不要求 Info 有单位元: 补齐出来的叶子 (下标 > n) 不参与合并，`apply_to` 收到的区间也截断到 [1, n]。
+ * 			4.3 树形与 SegTree 不同 (按 2 的幂切分而不是按 mid)，`pred` 不单调时两者的二分结果可能不同。
+ */
+
+template<SegInfo Info, class Tag>
+	requires SegTag<Tag, Info>
+struct SegTreeIter {
+	int n, lg, size;        // 区间长度，树高，叶子数 (2 的幂)
+	std::vector<Info> info; // info[p]: 结点 p 维护的区间信息
+	std::vector<Tag> tag;   // tag[p]: 内部结点 p 的懒标记
+
+	SegTreeIter() : n(0), lg(0), size(0) {}
+
+	SegTreeIter(int n) : SegTreeIter(std::vector<Info>(n + 1)) {}
+
+	SegTreeIter(const std::vector<Info>& init) : n((int)init.size() - 1), lg(0) {
+		AST(n >= 1);
+		while ((1 << lg) < n) ++lg;
+		size = 1 << lg;
+		info.assign(2 * size, Info());
+		tag.assign(size, Tag());
+		rep(i, 1, n) info[size + i - 1] = init[i];
+		per(p, size - 1, 1) _pull(p, lg - std::__lg(p));
+	}
+
+	void modify(int ql, int qr, const Tag& v) {
+		AST(1 <= ql && ql <= qr && qr <= n);
+		int l = ql - 1 + size, r = qr + size;
+		_push_bound(l, r);
+		for (int a = l, b = r, h = 0; a < b; a >>= 1, b >>= 1, ++h) {
+			if (a & 1) _apply(a++, v, h);
+			if (b & 1) _apply(--b, v, h);
+		}
+		rep(i, 1, lg) {
+			if (((l >> i) << i) != l) _pull(l >> i, i);
+			if (((r >> i) << i) != r) _pull((r - 1) >> i, i);
+		}
+	}
+
+	Info query(int ql, int qr) {
+		AST(1 <= ql && ql <= qr && qr <= n);
+		int l = ql - 1 + size, r = qr + size;
+		_push_bound(l, r);
+		Info sl, sr;
+		bool hl = false, hr = false;
+		for (; l < r; l >>= 1, r >>= 1) {
+			if (l & 1) sl = hl ? sl + info[l] : info[l], hl = true, ++l;
+			if (r & 1) --r, sr = hr ? info[r] + sr : info[r], hr = true;
+		}
+		if (!hl) return sr;
+		return hr ? sl + sr : sl;
+	}
+
+	Info all_info() const {
+		AST(n >= 1);
+		return info[1];
+	}
+
+	void set(int pos, const Info& v) {
+		AST(1 <= pos && pos <= n);
+		int p = pos - 1 + size;
+		per(i, lg, 1) _push(p >> i, i);
+		info[p] = v;
+		rep(i, 1, lg) _pull(p >> i, i);
+	}
+
+	template<class Pred>
+	int find_first(int ql, int qr, Pred pred) {
+		AST(1 <= ql && ql <= qr && qr <= n);
+		int l = ql - 1 + size, r = qr + size, cl = 0, cr = 0;
+		int nl[32], hl[32], nr[32], hr[32];
+		_push_bound(l, r);
+		for (int h = 0; l < r; l >>= 1, r >>= 1, ++h) {
+			if (l & 1) nl[cl] = l++, hl[cl++] = h;
+			if (r & 1) nr[cr] = --r, hr[cr++] = h;
+		}
+		rep(i, 0, cl - 1) if (pred(info[nl[i]])) return _descend_first(nl[i], hl[i], pred);
+		per(i, cr - 1, 0) if (pred(info[nr[i]])) return _descend_first(nr[i], hr[i], pred);
+		return -1;
+	}
+
+	template<class Pred>
+	int find_last(int ql, int qr, Pred pred) {
+		AST(1 <= ql && ql <= qr && qr <= n);
+		int l = ql - 1 + size, r = qr + size, cl = 0, cr = 0;
+		int nl[32], hl[32], nr[32], hr[32];
+		_push_bound(l, r);
+		for (int h = 0; l < r; l >>= 1, r >>= 1, ++h) {
+			if (l & 1) nl[cl] = l++, hl[cl++] = h;
+			if (r & 1) nr[cr] = --r, hr[cr++] = h;
+		}
+		rep(i, 0, cr - 1) if (pred(info[nr[i]])) return _descend_last(nr[i], hr[i], pred);
+		per(i, cl - 1, 0) if (pred(info[nl[i]])) return _descend_last(nl[i], hl[i], pred);
+		return -1;
+	}
+
+	template<class Pred>
+	int max_right(int ql, Pred pred) {
+		AST(1 <= ql && ql <= n + 1);
+		if (ql > n) return n;
+		int l = ql - 1 + size, h = 0;
+		per(i, lg, 1) _push(l >> i, i);
+		Info acc;
+		bool has = false;
+		do {
+			while (!(l & 1)) l >>= 1, ++h;
+			if (_left(l, h) >= n) break;
+			Info t = has ? acc + info[l] : info[l];
+			if (!pred(t)) {
+				for (; h; --h) {
+					_push(l, h);
+					l <<= 1;
+					Info u = has ? acc + info[l] : info[l];
+					if (pred(u)) acc = u, has = true, ++l;
+				}
+				return l - size;
+			}
+			acc = t, has = true, ++l;
+		} while ((l & -l) != l);
+		return n;
+	}
+
+	template<class Pred>
+	int min_left(int qr, Pred pred) {
+		AST(0 <= qr && qr <= n);
+		if (qr < 1) return 1;
+		int r = qr + size, h = 0;
+		per(i, lg, 1) _push((r - 1) >> i, i);
+		Info acc;
+		bool has = false;
+		do {
+			--r;
+			while (r > 1 && (r & 1)) r >>= 1, ++h;
+			Info t = has ? info[r] + acc : info[r];
+			if (!pred(t)) {
+				for (; h; --h) {
+					_push(r, h);
+					r = r << 1 | 1;
+					Info u = has ? info[r] + acc : info[r];
+					if (pred(u)) acc = u, has = true, --r;
+				}
+				return r - size + 2;
+			}
+			acc = t, has = true;
+		} while ((r & -r) != r);
+		return 1;
+	}
+
+	// 高为 h 的结点 p 覆盖的最左叶子 (0-based)，超过 n - 1 说明整个结点都在补齐部分
+	int _left(int p, int h) const { return (p << h) - size; }
+
+	// 高为 h 的结点 p，右儿子整个在补齐部分时只取左儿子
+	void _pull(int p, int h) {
+		if (_left(p << 1 | 1, h - 1) >= n) info[p] = info[p << 1];
+		else info[p] = info[p << 1] + info[p << 1 | 1];
+	}
+
+	// 只对与 [1, n] 有交的结点调用
+	void _apply(int p, const Tag& v, int h) {
+		int l = _left(p, h);
+		v.apply_to(info[p], l + 1, std::min(l + (1 << h), n));
+		if (h) tag[p].merge(v);
+	}
+
+	void _push(int p, int h) {
+		if (!tag[p].has_value()) return;
+		_apply(p << 1, tag[p], h - 1);
+		if (_left(p << 1 | 1, h - 1) < n) _apply(p << 1 | 1, tag[p], h - 1);
+		tag[p] = Tag();
+	}
+
+	// 下推半开区间 [l, r) (叶子下标) 两端点的所有真祖先
+	void _push_bound(int l, int r) {
+		per(i, lg, 1) {
+			if (((l >> i) << i) != l) _push(l >> i, i);
+			if (((r >> i) << i) != r) _push((r - 1) >> i, i);
+		}
+	}
+
+	template<class Pred>
+	int _descend_first(int p, int h, Pred& pred) {
+		for (; h; --h) {
+			_push(p, h);
+			p <<= 1;
+			if (!pred(info[p])) p |= 1;
+		}
+		return p - size + 1;
+	}
+
+	template<class Pred>
+	int _descend_last(int p, int h, Pred& pred) {
+		for (; h; --h) {
+			_push(p, h);
+			p = p << 1 | 1;
+			if (_left(p, h - 1) >= n || !pred(info[p])) p ^= 1;
+		}
+		return p - size + 1;
+	}
+};
+
+template<SegInfo Info>
+using SegTreeIterPoint = SegTreeIter<Info, SegNullTag<Info>>;